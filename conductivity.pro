@@ -48,6 +48,21 @@ SOURCES += axesdialog.cpp
 SOURCES += AxisLimits.cpp
 SOURCES += AxisFrame.cpp
 SOURCES += DataSetProperties.cpp
+SOURCES += noiseestimator.cpp
+SOURCES += sweepstatistics.cpp
+SOURCES += sweepprogram.cpp
+SOURCES += excitationcontroller.cpp
+SOURCES += prescan.cpp
+SOURCES += settlingtable.cpp
+SOURCES += stabilitydetector.cpp
+SOURCES += temperaturesampler.cpp
+SOURCES += temperatureseries.cpp
+SOURCES += thermalstability.cpp
+SOURCES += tstepscheduler.cpp
+SOURCES += temperaturegrid.cpp
+SOURCES += temperatureprofile.cpp
+SOURCES += thermalmodel.cpp
+SOURCES += pidzonetable.cpp
 
 HEADERS += mainwindow.h
 HEADERS += plotpropertiesdlg.h
@@ -67,6 +82,21 @@ HEADERS += axesdialog.h
 HEADERS += AxisLimits.h
 HEADERS += AxisFrame.h
 HEADERS += DataSetProperties.h
+HEADERS += noiseestimator.h
+HEADERS += sweepstatistics.h
+HEADERS += sweepprogram.h
+HEADERS += excitationcontroller.h
+HEADERS += prescan.h
+HEADERS += settlingtable.h
+HEADERS += stabilitydetector.h
+HEADERS += temperaturesampler.h
+HEADERS += temperatureseries.h
+HEADERS += thermalstability.h
+HEADERS += tstepscheduler.h
+HEADERS += temperaturegrid.h
+HEADERS += temperatureprofile.h
+HEADERS += thermalmodel.h
+HEADERS += pidzonetable.h
 
 
 FORMS   += mainwindow.ui
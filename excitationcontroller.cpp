@@ -0,0 +1,74 @@
+/*
+ *
+Copyright (C) 2016  Gabriele Salvato
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*/
+#include "excitationcontroller.h"
+
+#include <QtMath>
+
+
+ExcitationController::ExcitationController()
+    : minBias(0.0)
+    , maxBias(0.0)
+    , nBelow(0)
+{
+}
+
+
+// Bias limits (absolute values)
+void
+ExcitationController::setup(double dMinBias, double dMaxBias) {
+    maxBias = qAbs(dMaxBias);
+    minBias = qMin(qAbs(dMinBias), maxBias);
+    nBelow  = 0;
+}
+
+
+// Returns true and the new bias in pNewBias when the measure is
+// out of the window. The bias is decreased at once when the measure
+// approaches the compliance, but it is increased only after nConfirm
+// low readings, so a single spike does not change the excitation.
+bool
+ExcitationController::update(double dBias, double dMeasure, double dCompliance, double *pNewBias) {
+    double dLimit = qAbs(dCompliance);
+    double dValue = qAbs(dMeasure);
+    if((dBias == 0.0) || (dLimit == 0.0) || (maxBias == 0.0))
+        return false;
+    if(dValue > highFraction*dLimit) {
+        nBelow = 0;
+    }
+    else if(dValue < lowFraction*dLimit) {
+        nBelow++;
+        if(nBelow < nConfirm)
+            return false;
+        nBelow = 0;
+    }
+    else {
+        nBelow = 0;
+        return false;
+    }
+    double dRatio = maxRatio;
+    if(dValue > 0.0)
+        dRatio = qBound(1.0/maxRatio, targetFraction*dLimit/dValue, maxRatio);
+    double dNewBias = qBound(minBias, qAbs(dBias)*dRatio, maxBias);
+    if(dBias < 0.0)
+        dNewBias = -dNewBias;
+    if(qAbs(dNewBias-dBias) <= 1.0e-6*qAbs(dBias))
+        return false;// Already at the limit
+    *pNewBias = dNewBias;
+    return true;
+}
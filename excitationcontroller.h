@@ -0,0 +1,46 @@
+/*
+ *
+Copyright (C) 2016  Gabriele Salvato
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*/
+#pragma once
+
+
+// Keeps the measured quantity inside a window of the present
+// compliance by scaling the applied bias between readings:
+// the sample resistance may change by decades during a ramp.
+class ExcitationController
+{
+public:
+    ExcitationController();
+    void   setup(double dMinBias, double dMaxBias);
+    bool   update(double dBias, double dMeasure, double dCompliance, double *pNewBias);
+
+public:
+    // Fractions of the compliance
+    const double lowFraction    = 0.05;
+    const double highFraction   = 0.7;
+    const double targetFraction = 0.25;
+
+private:
+    double minBias;
+    double maxBias;
+    int    nBelow;
+    // Readings below the window needed before increasing the bias
+    const int    nConfirm = 2;
+    // Max bias change in a single step
+    const double maxRatio = 10.0;
+};
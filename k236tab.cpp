@@ -18,6 +18,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 #include "k236tab.h"
 #include "mainwindow.h"
+#include "keithley236.h"
 
 #include <QLineEdit>
 #include <QLabel>
@@ -30,6 +31,23 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 K236Tab::K236Tab(int iConfiguration, QWidget *parent)
     : QWidget(parent)
     , bSourceI(true)
+    , bContinuous(false)
+    , bBurst(false)
+    , bDelta(false)
+    , bTrackExcitation(false)
+    , dMaxBias(0.0)
+    , bPreScan(false)
+    , bApplyPreScan(false)
+    , bAutoDelay(false)
+    , bStabilityCheck(false)
+    , dMaxDrift(0.1)
+    , bJunctionCheck(false)
+    , dJunctionBias(1.0)
+    , dJunctionCompliance(1.0e-4)
+    , bHysteresis(false)
+    , bPulsed(false)
+    , iCompliancePolicy(Keithley236::ComplianceContinue)
+    , iSpeedProfile(Keithley236::ProfilePrecise)
     , currentMin(-1.0e-2)
     , currentMax(1.0e-2)
     , voltageMin(-110.0)
@@ -37,14 +55,50 @@ K236Tab::K236Tab(int iConfiguration, QWidget *parent)
     , waitTimeMin(100)
     , waitTimeMax(65000)
     , nSweepPointsMin(3)
-    , nSweepPointsMax(500)
+    , nSweepPointsMax(10000)// Long sweeps are split in chunks
     , intervalMin(0.1)
     , intervalMax(60.0)
+    , nBurstPointsMin(1)
+    , nBurstPointsMax(1000)// The K236 Sweep Buffer size
+    , burstDelayMin(0)
+    , burstDelayMax(65000)
+    , precisionMin(0.001)
+    , precisionMax(10.0)
+    , maxRepeatsMin(1)
+    , maxRepeatsMax(100)
+    , targetErrorMin(0.01)
+    , targetErrorMax(10.0)
+    , pulseTimeMin(5)
+    , pulseTimeMax(65000)
+    , maxDriftMin(0.001)
+    , maxDriftMax(10.0)
     , myConfiguration(iConfiguration)
 {
     // Create UI Elements
     SourceIButton.setText(QString("Source I - Measure V"));
     SourceVButton.setText(QString("Source V - Measure I"));
+    ContinuousCheckBox.setText(QString("Hardware Paced"));
+    BurstCheckBox.setText(QString("Burst (Sweep Buffer)"));
+    DeltaCheckBox.setText(QString("Delta Mode"));
+    TrackCheckBox.setText(QString("Track Excitation"));
+    PreScanCheckBox.setText(QString("Pre-scan"));
+    ApplyPreScanCheckBox.setText(QString("Apply Pre-scan"));
+    AutoDelayCheckBox.setText(QString("Auto Delay"));
+    StabilityCheckBox.setText(QString("Wait Electrical Stability"));
+    JunctionCheckBox.setText(QString("Junction Check"));
+    HysteresisCheckBox.setText(QString("Hysteresis Loop"));
+    PulsedCheckBox.setText(QString("Pulsed Sweep"));
+    // Same order of Keithley236::speedProfile
+    SpeedProfileCombo.addItem(QString("Precise"));
+    SpeedProfileCombo.addItem(QString("Normal"));
+    SpeedProfileCombo.addItem(QString("Fast"));
+    SpeedProfileCombo.addItem(QString("Fastest"));
+    SpeedProfileCombo.addItem(QString("Adaptive"));
+    // Same order of Keithley236::compliancePolicy
+    CompliancePolicyCombo.addItem(QString("Continue"));
+    CompliancePolicyCombo.addItem(QString("Raise Compliance"));
+    CompliancePolicyCombo.addItem(QString("Skip Point"));
+    CompliancePolicyCombo.addItem(QString("Abort"));
 
     // Build the Tab layout
     QGridLayout* pLayout = new QGridLayout();
@@ -69,10 +123,62 @@ K236Tab::K236Tab(int iConfiguration, QWidget *parent)
         pLayout->addWidget(&StopEdit,        2, 1, 1, 1);
         pLayout->addWidget(&WaitTimeEdit,    4, 1, 1, 1);
         pLayout->addWidget(&SweepPointsEdit, 5, 1, 1, 1);
+        pLayout->addWidget(&JunctionCheckBox,   6, 0, 1, 1);
+        pLayout->addWidget(&HysteresisCheckBox, 6, 1, 1, 1);
+        pLayout->addWidget(new QLabel("Max Repeats"),      7, 0, 1, 1);
+        pLayout->addWidget(&MaxRepeatsEdit,                7, 1, 1, 1);
+        pLayout->addWidget(new QLabel("Target Error [%]"), 8, 0, 1, 1);
+        pLayout->addWidget(&TargetErrorEdit,               8, 1, 1, 1);
     }
     else {
         pLayout->addWidget(&MeasureIntervalEdit, 4, 1, 1, 1);
     }
+    // In R vs T the readings alternate dark and photo:
+    // the lamp cannot follow the instrument reading rate
+    if(myConfiguration == MainWindow::iConfRvsTime)
+        pLayout->addWidget(&ContinuousCheckBox, 5, 0, 1, 1);
+    if((myConfiguration == MainWindow::iConfRvsT) ||
+       (myConfiguration == MainWindow::iConfRvsTime))
+        pLayout->addWidget(&DeltaCheckBox,      5, 1, 1, 1);
+    if(myConfiguration == MainWindow::iConfRvsTime) {
+        pLayout->addWidget(&BurstCheckBox,                  6, 0, 1, 2);
+        pLayout->addWidget(new QLabel("Burst Points"),      7, 0, 1, 1);
+        pLayout->addWidget(&BurstPointsEdit,                7, 1, 1, 1);
+        pLayout->addWidget(new QLabel("Burst Delay [ms]"),  8, 0, 1, 1);
+        pLayout->addWidget(&BurstDelayEdit,                 8, 1, 1, 1);
+    }
+    pLayout->addWidget(new QLabel("Speed Profile"),  9, 0, 1, 1);
+    pLayout->addWidget(&SpeedProfileCombo,           9, 1, 1, 1);
+    pLayout->addWidget(new QLabel("Precision [%]"), 10, 0, 1, 1);
+    pLayout->addWidget(&PrecisionEdit,              10, 1, 1, 1);
+    if(myConfiguration == MainWindow::iConfIvsV) {
+        pLayout->addWidget(&PulsedCheckBox,                11, 0, 1, 2);
+        pLayout->addWidget(new QLabel("Pulse On [ms]"),    12, 0, 1, 1);
+        pLayout->addWidget(&PulseOnEdit,                   12, 1, 1, 1);
+        pLayout->addWidget(new QLabel("Pulse Off [ms]"),   13, 0, 1, 1);
+        pLayout->addWidget(&PulseOffEdit,                  13, 1, 1, 1);
+        pLayout->addWidget(&AutoDelayCheckBox,             16, 0, 1, 2);
+        pLayout->addWidget(&StabilityCheckBox,             17, 0, 1, 2);
+        pLayout->addWidget(new QLabel("Max Drift [%/min]"), 18, 0, 1, 1);
+        pLayout->addWidget(&MaxDriftEdit,                  18, 1, 1, 1);
+        pLayout->addWidget(new QLabel("Junction |V| [V]"),      19, 0, 1, 1);
+        pLayout->addWidget(&JunctionBiasEdit,                   19, 1, 1, 1);
+        pLayout->addWidget(new QLabel("Junction Compliance [A]"), 20, 0, 1, 1);
+        pLayout->addWidget(&JunctionComplianceEdit,             20, 1, 1, 1);
+    }
+    pLayout->addWidget(new QLabel("On Compliance"),  14, 0, 1, 1);
+    pLayout->addWidget(&CompliancePolicyCombo,       14, 1, 1, 1);
+    pLayout->addWidget(new QLabel("Max Compliance"), 15, 0, 1, 1);
+    pLayout->addWidget(&MaxComplianceEdit,           15, 1, 1, 1);
+    if((myConfiguration == MainWindow::iConfRvsT) ||
+       (myConfiguration == MainWindow::iConfRvsTime))
+    {
+        pLayout->addWidget(&TrackCheckBox,  16, 0, 1, 2);
+        pLayout->addWidget(&MaxBiasLabel,   17, 0, 1, 1);
+        pLayout->addWidget(&MaxBiasEdit,    17, 1, 1, 1);
+        pLayout->addWidget(&PreScanCheckBox,      18, 0, 1, 1);
+        pLayout->addWidget(&ApplyPreScanCheckBox, 18, 1, 1, 1);
+    }
     // Set the Layout
     setLayout(pLayout);
 
@@ -100,6 +206,31 @@ K236Tab::restoreSettings() {
     iWaitTime     = settings.value("K236TabWaitTime", 100).toInt();
     iNSweepPoints = settings.value("K236TabSweepPoints", 100).toInt();
     dInterval     = settings.value("K236TabMeasureInterval", 0.1).toDouble();
+    bContinuous   = settings.value("K236TabContinuous", false).toBool();
+    bBurst        = settings.value("K236TabBurst", false).toBool();
+    bDelta        = settings.value("K236TabDelta", false).toBool();
+    bTrackExcitation = settings.value("K236TabTrackExcitation", false).toBool();
+    dMaxBias      = settings.value("K236TabMaxBias", 0.0).toDouble();
+    bPreScan      = settings.value("K236TabPreScan", false).toBool();
+    bApplyPreScan = settings.value("K236TabApplyPreScan", false).toBool();
+    bAutoDelay    = settings.value("K236TabAutoDelay", false).toBool();
+    bStabilityCheck = settings.value("K236TabStabilityCheck", false).toBool();
+    dMaxDrift     = settings.value("K236TabMaxDrift", 0.1).toDouble();
+    iBurstPoints  = settings.value("K236TabBurstPoints", 1000).toInt();
+    iBurstDelay   = settings.value("K236TabBurstDelay", 0).toInt();
+    bJunctionCheck= settings.value("K236TabJunctionCheck", false).toBool();
+    dJunctionBias = settings.value("K236TabJunctionBias", 1.0).toDouble();
+    dJunctionCompliance = settings.value("K236TabJunctionCompliance", 1.0e-4).toDouble();
+    bHysteresis   = settings.value("K236TabHysteresis", false).toBool();
+    bPulsed       = settings.value("K236TabPulsed", false).toBool();
+    iPulseOn      = settings.value("K236TabPulseOn", 10).toInt();
+    iPulseOff     = settings.value("K236TabPulseOff", 100).toInt();
+    iCompliancePolicy = settings.value("K236TabCompliancePolicy", Keithley236::ComplianceContinue).toInt();
+    dMaxCompliance    = settings.value("K236TabMaxCompliance", 0.0).toDouble();
+    iSpeedProfile = settings.value("K236TabSpeedProfile", Keithley236::ProfilePrecise).toInt();
+    dPrecision    = settings.value("K236TabPrecision", 0.1).toDouble();
+    iMaxRepeats   = settings.value("K236TabMaxRepeats", 1).toInt();
+    dTargetError  = settings.value("K236TabTargetError", 1.0).toDouble();
 }
 
 
@@ -113,6 +244,64 @@ K236Tab::saveSettings() {
     settings.setValue("K236TabWaitTime",    iWaitTime);
     settings.setValue("K236TabSweepPoints", iNSweepPoints);
     settings.setValue("K236TabMeasureInterval", dInterval);
+    settings.setValue("K236TabContinuous",  bContinuous);
+    settings.setValue("K236TabBurst",       bBurst);
+    settings.setValue("K236TabDelta",       bDelta);
+    settings.setValue("K236TabTrackExcitation", bTrackExcitation);
+    settings.setValue("K236TabMaxBias",     dMaxBias);
+    settings.setValue("K236TabPreScan",     bPreScan);
+    settings.setValue("K236TabApplyPreScan", bApplyPreScan);
+    settings.setValue("K236TabAutoDelay",   bAutoDelay);
+    settings.setValue("K236TabStabilityCheck", bStabilityCheck);
+    settings.setValue("K236TabMaxDrift",    dMaxDrift);
+    settings.setValue("K236TabBurstPoints", iBurstPoints);
+    settings.setValue("K236TabBurstDelay",  iBurstDelay);
+    settings.setValue("K236TabJunctionCheck", bJunctionCheck);
+    settings.setValue("K236TabJunctionBias", dJunctionBias);
+    settings.setValue("K236TabJunctionCompliance", dJunctionCompliance);
+    settings.setValue("K236TabHysteresis",  bHysteresis);
+    settings.setValue("K236TabPulsed",      bPulsed);
+    settings.setValue("K236TabPulseOn",     iPulseOn);
+    settings.setValue("K236TabPulseOff",    iPulseOff);
+    settings.setValue("K236TabCompliancePolicy", iCompliancePolicy);
+    settings.setValue("K236TabMaxCompliance", dMaxCompliance);
+    settings.setValue("K236TabSpeedProfile", iSpeedProfile);
+    settings.setValue("K236TabPrecision",   dPrecision);
+    settings.setValue("K236TabMaxRepeats",  iMaxRepeats);
+    settings.setValue("K236TabTargetError", dTargetError);
+}
+
+
+QString
+K236Tab::speedProfileName() {
+    return SpeedProfileCombo.itemText(iSpeedProfile);
+}
+
+
+// Applies the source mode, bias and compliance proposed by the
+// pre-scan. Out of range values leave the tab unchanged.
+bool
+K236Tab::applyPreScan(bool bNewSourceI, double dBias, double dNewCompliance) {
+    bool bOldSourceI = bSourceI;
+    // The validity of the values depends on the source mode
+    bSourceI = bNewSourceI;
+    bool bValid = bSourceI ? isCurrentValid(dBias) : isVoltageValid(dBias);
+    bValid = bValid && isComplianceValid(dNewCompliance);
+    // The maximum bias of the old source is meaningless
+    double dNewMaxBias = dMaxBias;
+    if(bSourceI != bOldSourceI)
+        dNewMaxBias = qMin(100.0*qAbs(dBias), bSourceI ? currentMax : voltageMax);
+    bValid = bValid && isBiasValid(dNewMaxBias);
+    if(!bValid) {
+        bSourceI = bOldSourceI;
+        return false;
+    }
+    dStart = dBias;
+    dCompliance = dNewCompliance;
+    dMaxBias = dNewMaxBias;
+    initUI();
+    saveSettings();
+    return true;
 }
 
 
@@ -134,6 +323,39 @@ K236Tab::setToolTips() {
     WaitTimeEdit.setToolTip(sHeader.arg(waitTimeMin).arg(waitTimeMax));
     SweepPointsEdit.setToolTip((sHeader.arg(nSweepPointsMin).arg(nSweepPointsMax)));
     MeasureIntervalEdit.setToolTip(sHeader.arg(intervalMin).arg(intervalMax));
+    ContinuousCheckBox.setToolTip("Let the K236 trigger itself and read every completed measure");
+    BurstCheckBox.setToolTip("Acquire bursts of readings in the K236 Sweep Buffer");
+    DeltaCheckBox.setToolTip("Reverse the bias at every reading to cancel the thermoelectric offsets");
+    TrackCheckBox.setToolTip("Change the bias to keep the measure well inside the compliance");
+    PreScanCheckBox.setToolTip("Run a quick I-V around zero to check the sample before the measure");
+    ApplyPreScanCheckBox.setToolTip("Use the source mode, bias and compliance proposed by the pre-scan");
+    StabilityCheckBox.setToolTip("Start the sweep as soon as the sample resistance stops drifting (T Stabilize Time is the upper bound)");
+    MaxDriftEdit.setToolTip(sHeader.arg(maxDriftMin).arg(maxDriftMax));
+    AutoDelayCheckBox.setToolTip("Measure the settling time on each source range and use it as delay (Wait Time is the upper bound)");
+    BurstPointsEdit.setToolTip(sHeader.arg(nBurstPointsMin).arg(nBurstPointsMax));
+    BurstDelayEdit.setToolTip(sHeader.arg(burstDelayMin).arg(burstDelayMax));
+    JunctionCheckBox.setToolTip("Check the junction direction before each Source I sweep");
+    JunctionBiasEdit.setToolTip(QString("Max |V| of the Junction Check and of the V sweep: ") +
+                                sHeader.arg(0.0).arg(voltageMax));
+    JunctionComplianceEdit.setToolTip(QString("Current Compliance of the Junction Check and of the V sweep: ") +
+                                      sHeader.arg(0.0).arg(currentMax));
+    HysteresisCheckBox.setToolTip("Sweep from Start to Stop and back to Start in a single operation");
+    PulsedCheckBox.setToolTip("Measure each point during a pulse to avoid the sample self heating");
+    PulseOnEdit.setToolTip(sHeader.arg(pulseTimeMin).arg(pulseTimeMax));
+    PulseOffEdit.setToolTip(sHeader.arg(pulseTimeMin).arg(pulseTimeMax));
+    CompliancePolicyCombo.setToolTip("Raise and Skip act on the dc measures only; Abort after repeated compliance events");
+    if(bSourceI) {
+        MaxComplianceEdit.setToolTip(sHeader.arg(voltageMin).arg(voltageMax));
+        MaxBiasEdit.setToolTip(sHeader.arg(0.0).arg(currentMax));
+    }
+    else {
+        MaxComplianceEdit.setToolTip(sHeader.arg(currentMin).arg(currentMax));
+        MaxBiasEdit.setToolTip(sHeader.arg(0.0).arg(voltageMax));
+    }
+    SpeedProfileCombo.setToolTip("Trade measure precision for reading speed");
+    PrecisionEdit.setToolTip(sHeader.arg(precisionMin).arg(precisionMax));
+    MaxRepeatsEdit.setToolTip(sHeader.arg(maxRepeatsMin).arg(maxRepeatsMax));
+    TargetErrorEdit.setToolTip(sHeader.arg(targetErrorMin).arg(targetErrorMax));
 }
 
 
@@ -193,6 +415,97 @@ K236Tab::initUI() {
         dInterval = intervalMin;
     }
     MeasureIntervalEdit.setText(QString("%1").arg(dInterval, 0, 'f', 2));
+    // Hardware Paced acquisition is available only in R vs Time
+    if(myConfiguration != MainWindow::iConfRvsTime)
+        bContinuous = false;
+    if(bContinuous && bBurst)
+        bBurst = false;
+    // Delta Mode needs a software triggered bias reversal
+    if(bDelta && (bContinuous || bBurst))
+        bDelta = false;
+    // The bias of a burst cannot be changed
+    if(bTrackExcitation && bBurst)
+        bTrackExcitation = false;
+    ContinuousCheckBox.setChecked(bContinuous);
+    BurstCheckBox.setChecked(bBurst);
+    DeltaCheckBox.setChecked(bDelta);
+    TrackCheckBox.setChecked(bTrackExcitation);
+    MaxBiasLabel.setText(bSourceI ? "Max |I| [A]" : "Max |V| [V]");
+    if(!isBiasValid(dMaxBias))
+        dMaxBias = 0.0;
+    MaxBiasEdit.setText(QString("%1").arg(dMaxBias, 0, 'g', 2));
+    MaxBiasEdit.setEnabled(bTrackExcitation);
+    PreScanCheckBox.setChecked(bPreScan);
+    ApplyPreScanCheckBox.setChecked(bApplyPreScan);
+    ApplyPreScanCheckBox.setEnabled(bPreScan);
+    AutoDelayCheckBox.setChecked(bAutoDelay);
+    // The pulse times replace the delay in pulsed sweeps
+    AutoDelayCheckBox.setEnabled(!bPulsed);
+    StabilityCheckBox.setChecked(bStabilityCheck);
+    if(!isMaxDriftValid(dMaxDrift))
+        dMaxDrift = 0.1;
+    MaxDriftEdit.setText(QString("%1").arg(dMaxDrift, 0, 'g', 3));
+    MaxDriftEdit.setEnabled(bStabilityCheck);
+    if(!isBurstPointNumberValid(iBurstPoints))
+        iBurstPoints = nBurstPointsMax;
+    BurstPointsEdit.setText(QString("%1").arg(iBurstPoints));
+    if(!isBurstDelayValid(iBurstDelay))
+        iBurstDelay = burstDelayMin;
+    BurstDelayEdit.setText(QString("%1").arg(iBurstDelay));
+    BurstPointsEdit.setEnabled(bBurst);
+    BurstDelayEdit.setEnabled(bBurst);
+    if(myConfiguration == MainWindow::iConfRvsTime)
+        MeasureIntervalEdit.setDisabled(bContinuous || bBurst);
+    // The junction direction is used only by Source I sweeps
+    JunctionCheckBox.setChecked(bJunctionCheck);
+    JunctionCheckBox.setEnabled(bSourceI);
+    if(!isJunctionBiasValid(dJunctionBias))
+        dJunctionBias = 1.0;
+    JunctionBiasEdit.setText(QString("%1").arg(dJunctionBias, 0, 'g', 3));
+    if(!isJunctionComplianceValid(dJunctionCompliance))
+        dJunctionCompliance = 1.0e-4;
+    JunctionComplianceEdit.setText(QString("%1").arg(dJunctionCompliance, 0, 'g', 3));
+    JunctionBiasEdit.setEnabled(bSourceI && bJunctionCheck);
+    JunctionComplianceEdit.setEnabled(bSourceI && bJunctionCheck);
+    HysteresisCheckBox.setChecked(bHysteresis);
+    PulsedCheckBox.setChecked(bPulsed);
+    if(!isPulseTimeValid(iPulseOn))
+        iPulseOn = 10;
+    PulseOnEdit.setText(QString("%1").arg(iPulseOn));
+    if(!isPulseTimeValid(iPulseOff))
+        iPulseOff = 100;
+    PulseOffEdit.setText(QString("%1").arg(iPulseOff));
+    PulseOnEdit.setEnabled(bPulsed);
+    PulseOffEdit.setEnabled(bPulsed);
+    // In pulsed sweeps the pulse times replace the wait time
+    if(myConfiguration == MainWindow::iConfIvsV)
+        WaitTimeEdit.setDisabled(bPulsed);
+    if((iCompliancePolicy < Keithley236::ComplianceContinue) ||
+       (iCompliancePolicy > Keithley236::ComplianceAbort))
+        iCompliancePolicy = Keithley236::ComplianceContinue;
+    CompliancePolicyCombo.setCurrentIndex(iCompliancePolicy);
+    if(!isComplianceValid(dMaxCompliance))
+        dMaxCompliance = 0.0;
+    MaxComplianceEdit.setText(QString("%1").arg(dMaxCompliance, 0, 'g', 2));
+    // The maximum compliance is used only when raising the compliance
+    MaxComplianceEdit.setEnabled(iCompliancePolicy == Keithley236::ComplianceRaise);
+    if((iSpeedProfile < Keithley236::ProfilePrecise) ||
+       (iSpeedProfile > Keithley236::ProfileAdaptive))
+        iSpeedProfile = Keithley236::ProfilePrecise;
+    SpeedProfileCombo.setCurrentIndex(iSpeedProfile);
+    if(!isPrecisionValid(dPrecision))
+        dPrecision = 0.1;
+    PrecisionEdit.setText(QString("%1").arg(dPrecision, 0, 'g', 3));
+    // The precision is used only to adapt the speed profile
+    PrecisionEdit.setEnabled(iSpeedProfile == Keithley236::ProfileAdaptive);
+    if(!isMaxRepeatsValid(iMaxRepeats))
+        iMaxRepeats = maxRepeatsMin;
+    MaxRepeatsEdit.setText(QString("%1").arg(iMaxRepeats));
+    if(!isTargetErrorValid(dTargetError))
+        dTargetError = 1.0;
+    TargetErrorEdit.setText(QString("%1").arg(dTargetError, 0, 'g', 3));
+    // A single sweep has no statistics
+    TargetErrorEdit.setEnabled(iMaxRepeats > 1);
     setToolTips();
 }
 
@@ -215,6 +528,56 @@ K236Tab::connectSignals() {
             this, SLOT(onSourceVChecked()));
     connect(&MeasureIntervalEdit, SIGNAL(textChanged(const QString)),
             this, SLOT(onMeasureIntervalEdit_textChanged(const QString)));
+    connect(&ContinuousCheckBox, SIGNAL(stateChanged(int)),
+            this, SLOT(onContinuousCheckBox_stateChanged(int)));
+    connect(&BurstCheckBox, SIGNAL(stateChanged(int)),
+            this, SLOT(onBurstCheckBox_stateChanged(int)));
+    connect(&DeltaCheckBox, SIGNAL(stateChanged(int)),
+            this, SLOT(onDeltaCheckBox_stateChanged(int)));
+    connect(&TrackCheckBox, SIGNAL(stateChanged(int)),
+            this, SLOT(onTrackCheckBox_stateChanged(int)));
+    connect(&MaxBiasEdit, SIGNAL(textChanged(const QString)),
+            this, SLOT(onMaxBiasEdit_textChanged(const QString)));
+    connect(&PreScanCheckBox, SIGNAL(stateChanged(int)),
+            this, SLOT(onPreScanCheckBox_stateChanged(int)));
+    connect(&ApplyPreScanCheckBox, SIGNAL(stateChanged(int)),
+            this, SLOT(onApplyPreScanCheckBox_stateChanged(int)));
+    connect(&AutoDelayCheckBox, SIGNAL(stateChanged(int)),
+            this, SLOT(onAutoDelayCheckBox_stateChanged(int)));
+    connect(&StabilityCheckBox, SIGNAL(stateChanged(int)),
+            this, SLOT(onStabilityCheckBox_stateChanged(int)));
+    connect(&MaxDriftEdit, SIGNAL(textChanged(const QString)),
+            this, SLOT(onMaxDriftEdit_textChanged(const QString)));
+    connect(&BurstPointsEdit, SIGNAL(textChanged(const QString)),
+            this, SLOT(onBurstPointsEdit_textChanged(const QString)));
+    connect(&BurstDelayEdit, SIGNAL(textChanged(const QString)),
+            this, SLOT(onBurstDelayEdit_textChanged(const QString)));
+    connect(&JunctionCheckBox, SIGNAL(stateChanged(int)),
+            this, SLOT(onJunctionCheckBox_stateChanged(int)));
+    connect(&JunctionBiasEdit, SIGNAL(textChanged(const QString)),
+            this, SLOT(onJunctionBiasEdit_textChanged(const QString)));
+    connect(&JunctionComplianceEdit, SIGNAL(textChanged(const QString)),
+            this, SLOT(onJunctionComplianceEdit_textChanged(const QString)));
+    connect(&HysteresisCheckBox, SIGNAL(stateChanged(int)),
+            this, SLOT(onHysteresisCheckBox_stateChanged(int)));
+    connect(&PulsedCheckBox, SIGNAL(stateChanged(int)),
+            this, SLOT(onPulsedCheckBox_stateChanged(int)));
+    connect(&PulseOnEdit, SIGNAL(textChanged(const QString)),
+            this, SLOT(onPulseOnEdit_textChanged(const QString)));
+    connect(&PulseOffEdit, SIGNAL(textChanged(const QString)),
+            this, SLOT(onPulseOffEdit_textChanged(const QString)));
+    connect(&CompliancePolicyCombo, SIGNAL(currentIndexChanged(int)),
+            this, SLOT(onCompliancePolicyCombo_currentIndexChanged(int)));
+    connect(&MaxComplianceEdit, SIGNAL(textChanged(const QString)),
+            this, SLOT(onMaxComplianceEdit_textChanged(const QString)));
+    connect(&SpeedProfileCombo, SIGNAL(currentIndexChanged(int)),
+            this, SLOT(onSpeedProfileCombo_currentIndexChanged(int)));
+    connect(&PrecisionEdit, SIGNAL(textChanged(const QString)),
+            this, SLOT(onPrecisionEdit_textChanged(const QString)));
+    connect(&MaxRepeatsEdit, SIGNAL(textChanged(const QString)),
+            this, SLOT(onMaxRepeatsEdit_textChanged(const QString)));
+    connect(&TargetErrorEdit, SIGNAL(textChanged(const QString)),
+            this, SLOT(onTargetErrorEdit_textChanged(const QString)));
 }
 
 
@@ -241,6 +604,32 @@ K236Tab::isComplianceValid(double dCompliance){
 }
 
 
+// The maximum bias is an absolute value
+bool
+K236Tab::isBiasValid(double dBias) {
+    if(dBias <= 0.0)
+        return false;
+    if(bSourceI)
+        return isCurrentValid(dBias);
+    else
+        return isVoltageValid(dBias);
+}
+
+
+// The Junction Check always sources voltage and measures
+// current, whatever the source mode of the sweep
+bool
+K236Tab::isJunctionBiasValid(double dBias) {
+    return (dBias > 0.0) && isVoltageValid(dBias);
+}
+
+
+bool
+K236Tab::isJunctionComplianceValid(double dCompliance) {
+    return (dCompliance > 0.0) && isCurrentValid(dCompliance);
+}
+
+
 bool
 K236Tab::isWaitTimeValid(int iWaitTime) {
     return (iWaitTime >= waitTimeMin) &&
@@ -261,6 +650,55 @@ K236Tab::isIntervalValid(double interval) {
 }
 
 
+bool
+K236Tab::isBurstPointNumberValid(int nPoints) {
+    return (nPoints >= nBurstPointsMin) &&
+            (nPoints <= nBurstPointsMax);
+}
+
+
+bool
+K236Tab::isBurstDelayValid(int iDelay) {
+    return (iDelay >= burstDelayMin) &&
+            (iDelay <= burstDelayMax);
+}
+
+
+bool
+K236Tab::isPrecisionValid(double precision) {
+    return (precision >= precisionMin) &&
+            (precision <= precisionMax);
+}
+
+
+bool
+K236Tab::isMaxDriftValid(double maxDrift) {
+    return (maxDrift >= maxDriftMin) &&
+            (maxDrift <= maxDriftMax);
+}
+
+
+bool
+K236Tab::isMaxRepeatsValid(int nRepeats) {
+    return (nRepeats >= maxRepeatsMin) &&
+            (nRepeats <= maxRepeatsMax);
+}
+
+
+bool
+K236Tab::isTargetErrorValid(double targetError) {
+    return (targetError >= targetErrorMin) &&
+            (targetError <= targetErrorMax);
+}
+
+
+bool
+K236Tab::isPulseTimeValid(int iPulseTime) {
+    return (iPulseTime >= pulseTimeMin) &&
+            (iPulseTime <= pulseTimeMax);
+}
+
+
 void
 K236Tab::onStartEdit_textChanged(const QString &arg1) {
     double dTemp = arg1.toDouble();
@@ -355,3 +793,271 @@ K236Tab::onMeasureIntervalEdit_textChanged(const QString &arg1) {
 }
 
 
+void
+K236Tab::onContinuousCheckBox_stateChanged(int arg1) {
+    bContinuous = (arg1 == Qt::Checked);
+    if(bContinuous) {
+        BurstCheckBox.setChecked(false);
+        DeltaCheckBox.setChecked(false);
+    }
+    // The Measure Interval has no meaning when the
+    // Keithley 236 is triggering itself in R vs Time
+    if(myConfiguration == MainWindow::iConfRvsTime)
+        MeasureIntervalEdit.setDisabled(bContinuous || bBurst);
+}
+
+
+void
+K236Tab::onBurstCheckBox_stateChanged(int arg1) {
+    bBurst = (arg1 == Qt::Checked);
+    if(bBurst) {
+        ContinuousCheckBox.setChecked(false);
+        DeltaCheckBox.setChecked(false);
+        TrackCheckBox.setChecked(false);
+    }
+    BurstPointsEdit.setEnabled(bBurst);
+    BurstDelayEdit.setEnabled(bBurst);
+    if(myConfiguration == MainWindow::iConfRvsTime)
+        MeasureIntervalEdit.setDisabled(bContinuous || bBurst);
+}
+
+
+void
+K236Tab::onDeltaCheckBox_stateChanged(int arg1) {
+    bDelta = (arg1 == Qt::Checked);
+    if(bDelta) {
+        ContinuousCheckBox.setChecked(false);
+        BurstCheckBox.setChecked(false);
+    }
+}
+
+
+void
+K236Tab::onTrackCheckBox_stateChanged(int arg1) {
+    bTrackExcitation = (arg1 == Qt::Checked);
+    if(bTrackExcitation)
+        BurstCheckBox.setChecked(false);
+    MaxBiasEdit.setEnabled(bTrackExcitation);
+}
+
+
+void
+K236Tab::onMaxBiasEdit_textChanged(const QString &arg1) {
+    double dTemp = arg1.toDouble();
+    if(isBiasValid(dTemp)) {
+        dMaxBias = dTemp;
+        MaxBiasEdit.setStyleSheet(sNormalStyle);
+    }
+    else {
+        MaxBiasEdit.setStyleSheet(sErrorStyle);
+    }
+}
+
+
+void
+K236Tab::onPreScanCheckBox_stateChanged(int arg1) {
+    bPreScan = (arg1 == Qt::Checked);
+    ApplyPreScanCheckBox.setEnabled(bPreScan);
+}
+
+
+void
+K236Tab::onApplyPreScanCheckBox_stateChanged(int arg1) {
+    bApplyPreScan = (arg1 == Qt::Checked);
+}
+
+
+void
+K236Tab::onAutoDelayCheckBox_stateChanged(int arg1) {
+    bAutoDelay = (arg1 == Qt::Checked);
+}
+
+
+void
+K236Tab::onStabilityCheckBox_stateChanged(int arg1) {
+    bStabilityCheck = (arg1 == Qt::Checked);
+    MaxDriftEdit.setEnabled(bStabilityCheck);
+}
+
+
+void
+K236Tab::onMaxDriftEdit_textChanged(const QString &arg1) {
+    double dTemp = arg1.toDouble();
+    if(isMaxDriftValid(dTemp)) {
+        dMaxDrift = dTemp;
+        MaxDriftEdit.setStyleSheet(sNormalStyle);
+    }
+    else {
+        MaxDriftEdit.setStyleSheet(sErrorStyle);
+    }
+}
+
+
+void
+K236Tab::onBurstPointsEdit_textChanged(const QString &arg1) {
+    int iTemp = arg1.toInt();
+    if(isBurstPointNumberValid(iTemp)) {
+        iBurstPoints = iTemp;
+        BurstPointsEdit.setStyleSheet(sNormalStyle);
+    }
+    else {
+        BurstPointsEdit.setStyleSheet(sErrorStyle);
+    }
+}
+
+
+void
+K236Tab::onBurstDelayEdit_textChanged(const QString &arg1) {
+    int iTemp = arg1.toInt();
+    if(isBurstDelayValid(iTemp)) {
+        iBurstDelay = iTemp;
+        BurstDelayEdit.setStyleSheet(sNormalStyle);
+    }
+    else {
+        BurstDelayEdit.setStyleSheet(sErrorStyle);
+    }
+}
+
+
+void
+K236Tab::onJunctionCheckBox_stateChanged(int arg1) {
+    bJunctionCheck = (arg1 == Qt::Checked);
+    JunctionBiasEdit.setEnabled(bSourceI && bJunctionCheck);
+    JunctionComplianceEdit.setEnabled(bSourceI && bJunctionCheck);
+}
+
+
+void
+K236Tab::onJunctionBiasEdit_textChanged(const QString &arg1) {
+    double dTemp = arg1.toDouble();
+    if(isJunctionBiasValid(dTemp)) {
+        dJunctionBias = dTemp;
+        JunctionBiasEdit.setStyleSheet(sNormalStyle);
+    }
+    else {
+        JunctionBiasEdit.setStyleSheet(sErrorStyle);
+    }
+}
+
+
+void
+K236Tab::onJunctionComplianceEdit_textChanged(const QString &arg1) {
+    double dTemp = arg1.toDouble();
+    if(isJunctionComplianceValid(dTemp)) {
+        dJunctionCompliance = dTemp;
+        JunctionComplianceEdit.setStyleSheet(sNormalStyle);
+    }
+    else {
+        JunctionComplianceEdit.setStyleSheet(sErrorStyle);
+    }
+}
+
+
+void
+K236Tab::onHysteresisCheckBox_stateChanged(int arg1) {
+    bHysteresis = (arg1 == Qt::Checked);
+}
+
+
+void
+K236Tab::onPulsedCheckBox_stateChanged(int arg1) {
+    bPulsed = (arg1 == Qt::Checked);
+    PulseOnEdit.setEnabled(bPulsed);
+    PulseOffEdit.setEnabled(bPulsed);
+    if(myConfiguration == MainWindow::iConfIvsV)
+        WaitTimeEdit.setDisabled(bPulsed);
+    AutoDelayCheckBox.setEnabled(!bPulsed);
+}
+
+
+void
+K236Tab::onPulseOnEdit_textChanged(const QString &arg1) {
+    int iTemp = arg1.toInt();
+    if(isPulseTimeValid(iTemp)) {
+        iPulseOn = iTemp;
+        PulseOnEdit.setStyleSheet(sNormalStyle);
+    }
+    else {
+        PulseOnEdit.setStyleSheet(sErrorStyle);
+    }
+}
+
+
+void
+K236Tab::onPulseOffEdit_textChanged(const QString &arg1) {
+    int iTemp = arg1.toInt();
+    if(isPulseTimeValid(iTemp)) {
+        iPulseOff = iTemp;
+        PulseOffEdit.setStyleSheet(sNormalStyle);
+    }
+    else {
+        PulseOffEdit.setStyleSheet(sErrorStyle);
+    }
+}
+
+
+void
+K236Tab::onSpeedProfileCombo_currentIndexChanged(int index) {
+    iSpeedProfile = index;
+    PrecisionEdit.setEnabled(iSpeedProfile == Keithley236::ProfileAdaptive);
+}
+
+
+void
+K236Tab::onPrecisionEdit_textChanged(const QString &arg1) {
+    double dTemp = arg1.toDouble();
+    if(isPrecisionValid(dTemp)) {
+        dPrecision = dTemp;
+        PrecisionEdit.setStyleSheet(sNormalStyle);
+    }
+    else {
+        PrecisionEdit.setStyleSheet(sErrorStyle);
+    }
+}
+
+
+void
+K236Tab::onMaxRepeatsEdit_textChanged(const QString &arg1) {
+    int iTemp = arg1.toInt();
+    if(isMaxRepeatsValid(iTemp)) {
+        iMaxRepeats = iTemp;
+        MaxRepeatsEdit.setStyleSheet(sNormalStyle);
+    }
+    else {
+        MaxRepeatsEdit.setStyleSheet(sErrorStyle);
+    }
+    TargetErrorEdit.setEnabled(iMaxRepeats > 1);
+}
+
+
+void
+K236Tab::onTargetErrorEdit_textChanged(const QString &arg1) {
+    double dTemp = arg1.toDouble();
+    if(isTargetErrorValid(dTemp)) {
+        dTargetError = dTemp;
+        TargetErrorEdit.setStyleSheet(sNormalStyle);
+    }
+    else {
+        TargetErrorEdit.setStyleSheet(sErrorStyle);
+    }
+}
+
+
+void
+K236Tab::onCompliancePolicyCombo_currentIndexChanged(int index) {
+    iCompliancePolicy = index;
+    MaxComplianceEdit.setEnabled(iCompliancePolicy == Keithley236::ComplianceRaise);
+}
+
+
+void
+K236Tab::onMaxComplianceEdit_textChanged(const QString &arg1) {
+    double dTemp = arg1.toDouble();
+    if(isComplianceValid(dTemp)) {
+        dMaxCompliance = dTemp;
+        MaxComplianceEdit.setStyleSheet(sNormalStyle);
+    }
+    else {
+        MaxComplianceEdit.setStyleSheet(sErrorStyle);
+    }
+}
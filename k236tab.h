@@ -22,7 +22,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <QWidget>
 #include <QLineEdit>
 #include <QRadioButton>
+#include <QCheckBox>
 #include <QLabel>
+#include <QComboBox>
 
 
 class K236Tab : public QWidget
@@ -32,6 +34,8 @@ public:
     explicit K236Tab(int iConfiguration, QWidget *parent = nullptr);
     void restoreSettings();
     void saveSettings();
+    QString speedProfileName();
+    bool applyPreScan(bool bNewSourceI, double dBias, double dNewCompliance);
 
 signals:
 
@@ -44,6 +48,31 @@ public slots:
     void onWaitTimeEdit_textChanged(const QString &arg1);
     void onSweepPointsEdit_textChanged(const QString &arg1);
     void onMeasureIntervalEdit_textChanged(const QString &arg1);
+    void onContinuousCheckBox_stateChanged(int arg1);
+    void onBurstCheckBox_stateChanged(int arg1);
+    void onDeltaCheckBox_stateChanged(int arg1);
+    void onTrackCheckBox_stateChanged(int arg1);
+    void onMaxBiasEdit_textChanged(const QString &arg1);
+    void onPreScanCheckBox_stateChanged(int arg1);
+    void onAutoDelayCheckBox_stateChanged(int arg1);
+    void onStabilityCheckBox_stateChanged(int arg1);
+    void onMaxDriftEdit_textChanged(const QString &arg1);
+    void onApplyPreScanCheckBox_stateChanged(int arg1);
+    void onBurstPointsEdit_textChanged(const QString &arg1);
+    void onBurstDelayEdit_textChanged(const QString &arg1);
+    void onJunctionCheckBox_stateChanged(int arg1);
+    void onJunctionBiasEdit_textChanged(const QString &arg1);
+    void onJunctionComplianceEdit_textChanged(const QString &arg1);
+    void onHysteresisCheckBox_stateChanged(int arg1);
+    void onPulsedCheckBox_stateChanged(int arg1);
+    void onPulseOnEdit_textChanged(const QString &arg1);
+    void onPulseOffEdit_textChanged(const QString &arg1);
+    void onCompliancePolicyCombo_currentIndexChanged(int index);
+    void onMaxComplianceEdit_textChanged(const QString &arg1);
+    void onSpeedProfileCombo_currentIndexChanged(int index);
+    void onPrecisionEdit_textChanged(const QString &arg1);
+    void onMaxRepeatsEdit_textChanged(const QString &arg1);
+    void onTargetErrorEdit_textChanged(const QString &arg1);
 
 protected:
     void setToolTips();
@@ -53,9 +82,19 @@ protected:
     bool isCurrentValid(double dCurrent);
     bool isVoltageValid(double dVoltage);
     bool isComplianceValid(double dCompliance);
+    bool isBiasValid(double dBias);
     bool isWaitTimeValid(int iWaitTime);
     bool isSweepPointNumberValid(int nSweepPoints);
     bool isIntervalValid(double interval);
+    bool isBurstPointNumberValid(int nPoints);
+    bool isBurstDelayValid(int iDelay);
+    bool isPrecisionValid(double precision);
+    bool isMaxRepeatsValid(int nRepeats);
+    bool isTargetErrorValid(double targetError);
+    bool isPulseTimeValid(int iPulseTime);
+    bool isMaxDriftValid(double maxDrift);
+    bool isJunctionBiasValid(double dBias);
+    bool isJunctionComplianceValid(double dCompliance);
 
 public:
     double dStart;
@@ -65,6 +104,31 @@ public:
     int    iNSweepPoints;
     double dInterval;
     bool   bSourceI;
+    bool   bContinuous;
+    bool   bBurst;
+    bool   bDelta;
+    bool   bTrackExcitation;
+    double dMaxBias;
+    bool   bPreScan;
+    bool   bApplyPreScan;
+    bool   bAutoDelay;
+    bool   bStabilityCheck;
+    double dMaxDrift;
+    int    iBurstPoints;
+    int    iBurstDelay;
+    bool   bJunctionCheck;
+    double dJunctionBias;
+    double dJunctionCompliance;
+    bool   bHysteresis;
+    bool   bPulsed;
+    int    iPulseOn;
+    int    iPulseOff;
+    int    iCompliancePolicy;
+    double dMaxCompliance;
+    int    iSpeedProfile;
+    double dPrecision;
+    int    iMaxRepeats;
+    double dTargetError;
 
 private:
     // Limit Values
@@ -78,6 +142,20 @@ private:
     const int    nSweepPointsMax;
     const double intervalMin;
     const double intervalMax;
+    const int    nBurstPointsMin;
+    const int    nBurstPointsMax;
+    const int    burstDelayMin;
+    const int    burstDelayMax;
+    const double precisionMin;
+    const double precisionMax;
+    const int    maxRepeatsMin;
+    const int    maxRepeatsMax;
+    const double targetErrorMin;
+    const double targetErrorMax;
+    const int    pulseTimeMin;
+    const int    pulseTimeMax;
+    const double maxDriftMin;
+    const double maxDriftMax;
 
     // QLineEdit styles
     QString sNormalStyle;
@@ -95,6 +173,32 @@ private:
     QLineEdit    WaitTimeEdit;
     QLineEdit    SweepPointsEdit;
     QLineEdit    MeasureIntervalEdit;
+    QCheckBox    ContinuousCheckBox;
+    QCheckBox    BurstCheckBox;
+    QCheckBox    DeltaCheckBox;
+    QCheckBox    TrackCheckBox;
+    QLabel       MaxBiasLabel;
+    QLineEdit    MaxBiasEdit;
+    QCheckBox    PreScanCheckBox;
+    QCheckBox    ApplyPreScanCheckBox;
+    QCheckBox    AutoDelayCheckBox;
+    QCheckBox    StabilityCheckBox;
+    QLineEdit    MaxDriftEdit;
+    QLineEdit    BurstPointsEdit;
+    QLineEdit    BurstDelayEdit;
+    QCheckBox    JunctionCheckBox;
+    QLineEdit    JunctionBiasEdit;
+    QLineEdit    JunctionComplianceEdit;
+    QCheckBox    HysteresisCheckBox;
+    QCheckBox    PulsedCheckBox;
+    QLineEdit    PulseOnEdit;
+    QLineEdit    PulseOffEdit;
+    QComboBox    CompliancePolicyCombo;
+    QLineEdit    MaxComplianceEdit;
+    QComboBox    SpeedProfileCombo;
+    QLineEdit    PrecisionEdit;
+    QLineEdit    MaxRepeatsEdit;
+    QLineEdit    TargetErrorEdit;
 
     int          myConfiguration;
 };
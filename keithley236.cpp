@@ -23,10 +23,27 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <QThread>
 //#include <QDebug>
 
-#define MAX_COMPLIANCE_EVENTS 5
-
 namespace keithley236 {
 static int  rearmMask;
+// Integration times [s] selected by the S command (S0...S3)
+static const double integrationTime[4] = {416.0e-6, 4.0e-3, 16.67e-3, 20.0e-3};
+// Number of readings averaged by the P command (P0...P5)
+static const int    filterReadings[6] = {1, 2, 4, 8, 16, 32};
+// Burst acquisitions use the fastest unfiltered measure
+static const int    burstFilter = 0;
+static const int    burstIntegration = 1;
+// Filter and integration time of the fixed speed profiles:
+// Precise, Normal, Fast, Fastest
+static const int    profileFilter[4]      = {5, 3, 1, 0};
+static const int    profileIntegration[4] = {3, 2, 1, 0};
+// Full scale of the measure ranges selected by the L command
+// (the source ranges are the same)
+static const double voltageFullScale[3] = {1.1, 11.0, 110.0};
+static const double currentFullScale[9] = {1.0e-9, 1.0e-8, 1.0e-7, 1.0e-6, 1.0e-5,
+                                           1.0e-4, 1.0e-3, 1.0e-2, 1.0e-1};
+// A locked range must leave room for the measure to grow
+// until the next re-evaluation
+static const double rangeHeadroom = 0.5;
 #if !defined(Q_OS_LINUX)
 int __stdcall
 myCallback(int LocalUd, unsigned long LocalIbsta, unsigned long LocalIberr, long LocalIbcntl, void* callbackData) {
@@ -51,10 +68,38 @@ Keithley236::Keithley236(int gpio, int address, QObject *parent)
     , K236_ERROR(32)
     , COMPLIANCE(128)
     //
+    , MAX_SWEEP_POINTS(1000)
+    , MAX_COMPLIANCE_EVENTS(5)
+    //
     , isSweeping(false)
+    , isContinuous(false)
+    , burstPeriod(0.0)
+    , iFilter(5)
+    , iIntegration(3)
+    , iMeasureRange(0)
+    , dMeasureCompliance(0.0)
+    , bMeasureV(true)
+    , bDelta(false)
+    , dBias(0.0)
+    , deltaSign(1.0)
+    , bHaveDeltaReading(false)
+    , deltaResetRequest(0)
+    , jState(JunctionIdle)
 {
     iComplianceEvents = 0;
+    bInCompliance = false;
+    bReadingInCompliance = false;
+    // A compliance condition is cleared only when
+    // absent for at least complianceDebounce ms
+    complianceDebounce = 300;
     pollInterval = 569;
+    // In continuous mode every reading must be drained
+    // before the next one overwrites the output buffer
+    continuousPollInterval = 20;
+    junctionPollInterval = 100;
+    junctionTimer.setSingleShot(true);
+    connect(&junctionTimer, SIGNAL(timeout()),
+            this, SLOT(onJunctionCheckTimeout()));
 }
 
 
@@ -103,18 +148,33 @@ Keithley236::init() {
 #endif
     ibclr(gpibId);
     QThread::sleep(1);
+    iComplianceEvents = 0;
+    bInCompliance = false;
+    bDelta = false;
     return NO_ERROR;
 }
 
 
 int
-Keithley236::initVvsTSourceI(double dAppliedCurrent, double dCompliance) {
+Keithley236::initVvsTSourceI(double dAppliedCurrent, double dCompliance, bool bContinuous) {
+    dBias = dAppliedCurrent;
+    deltaSign = 1.0;
+    bHaveDeltaReading = false;
     iComplianceEvents = 0;
+    bInCompliance = false;
+    isSweeping = false;
+    isContinuous = bContinuous;
+    bMeasureV = true;
+    dMeasureCompliance = dCompliance;
+    iMeasureRange = 0;
     uint iErr = 0;
     iErr |= gpibWrite(gpibId, "M0,0");      // SRQ Disabled, SRQ on Compliance
     iErr |= gpibWrite(gpibId, "R0");        // Disarm Trigger
     iErr |= gpibWrite(gpibId, "O1");        // Remote Sense
-    iErr |= gpibWrite(gpibId, "T1,1,0,0");  // Trigger on GET ^SRC DLY MSR
+    if(isContinuous)
+        iErr |= gpibWrite(gpibId, "T0,0,0,0");  // Trigger on X, Continuous
+    else
+        iErr |= gpibWrite(gpibId, "T1,1,0,0");  // Trigger on GET ^SRC DLY MSR
     iErr |= gpibWrite(gpibId, "F1,1X");     // Place for a moment in Source I Measure V Sweep Mode
     // For some reason the Compliance command does not
     // works when in Source I Measure V dc condition
@@ -122,8 +182,10 @@ Keithley236::initVvsTSourceI(double dAppliedCurrent, double dCompliance) {
     iErr |= gpibWrite(gpibId, sCommand);    // Set Compliance, Autorange Measure
     iErr |= gpibWrite(gpibId, "G5,2,0");    // Output Source, Measure, No Prefix, DC
     iErr |= gpibWrite(gpibId, "Z0");        // Disable suppression
-    iErr |= gpibWrite(gpibId, "P5");        // 32 Reading Filter
-    iErr |= gpibWrite(gpibId, "S3");        // 20ms integration time
+    sCommand = QString("P%1").arg(iFilter);
+    iErr |= gpibWrite(gpibId, sCommand);    // Reading Filter
+    sCommand = QString("S%1").arg(iIntegration);
+    iErr |= gpibWrite(gpibId, sCommand);    // Integration time
     iErr |= gpibWrite(gpibId, "F1,0");      // Place in Source I Measure V
     sCommand = QString("B%1,0,0X").arg(dAppliedCurrent);
     iErr |= gpibWrite(gpibId, sCommand);    // Set Applied Current
@@ -142,25 +204,44 @@ Keithley236::initVvsTSourceI(double dAppliedCurrent, double dCompliance) {
     int srqMask =
             COMPLIANCE +
             K236_ERROR +
-            READY_FOR_TRIGGER +
             READING_DONE +
             WARNING;
+    // In continuous mode the instrument triggers itself:
+    // we are only interested in the completed readings
+    if(!isContinuous)
+        srqMask += READY_FOR_TRIGGER;
     sCommand = QString("M%1,0X").arg(srqMask);
     gpibWrite(gpibId, sCommand);   // SRQ Mask, Interrupt on Compliance
     if(isGpibError(QString(QString(Q_FUNC_INFO) + "%1").arg(sCommand)))
         exit(-1);
+#if defined(Q_OS_LINUX)
+    if(isContinuous)
+        pollTimer.start(continuousPollInterval);
+#endif
     return NO_ERROR;
 }
 
 
 int
-Keithley236::initVvsTSourceV(double dAppliedVoltage, double dCompliance) {
+Keithley236::initVvsTSourceV(double dAppliedVoltage, double dCompliance, bool bContinuous) {
+    dBias = dAppliedVoltage;
+    deltaSign = 1.0;
+    bHaveDeltaReading = false;
     iComplianceEvents = 0;
+    bInCompliance = false;
+    isSweeping = false;
+    isContinuous = bContinuous;
+    bMeasureV = false;
+    dMeasureCompliance = dCompliance;
+    iMeasureRange = 0;
     uint iErr = 0;
     iErr |= gpibWrite(gpibId, "M0,0");      // SRQ Disabled, SRQ on Compliance
     iErr |= gpibWrite(gpibId, "R0");        // Disarm Trigger
     iErr |= gpibWrite(gpibId, "O1");        // Remote Sense
-    iErr |= gpibWrite(gpibId, "T1,1,0,0");  // Trigger on GET ^SRC DLY MSR
+    if(isContinuous)
+        iErr |= gpibWrite(gpibId, "T0,0,0,0");  // Trigger on X, Continuous
+    else
+        iErr |= gpibWrite(gpibId, "T1,1,0,0");  // Trigger on GET ^SRC DLY MSR
     iErr |= gpibWrite(gpibId, "F0,1X");     // Place for a moment in Source V Measure I Sweep Mode
     // For some reason the Compliance command does not
     // works when in Source I Measure V dc condition
@@ -169,8 +250,10 @@ Keithley236::initVvsTSourceV(double dAppliedVoltage, double dCompliance) {
     iErr |= gpibWrite(gpibId, "F0,0");      // Source V Measure I dc
     iErr |= gpibWrite(gpibId, "G5,2,0");    // Output Source, Measure, No Prefix, DC
     iErr |= gpibWrite(gpibId, "Z0");        // Disable Zero suppression
-    iErr |= gpibWrite(gpibId, "P5");        // 32 Reading Filter
-    iErr |= gpibWrite(gpibId, "S3");        // 20ms integration time
+    sCommand = QString("P%1").arg(iFilter);
+    iErr |= gpibWrite(gpibId, sCommand);    // Reading Filter
+    sCommand = QString("S%1").arg(iIntegration);
+    iErr |= gpibWrite(gpibId, sCommand);    // Integration time
     sCommand = QString("B%1,0,0X").arg(dAppliedVoltage);
     iErr |= gpibWrite(gpibId, sCommand);    // Set Applied Current
     iErr |= gpibWrite(gpibId, "R1");        // Arm Trigger
@@ -188,13 +271,20 @@ Keithley236::initVvsTSourceV(double dAppliedVoltage, double dCompliance) {
     int srqMask =
             COMPLIANCE +
             K236_ERROR +
-            READY_FOR_TRIGGER +
             READING_DONE +
             WARNING;
+    // In continuous mode the instrument triggers itself:
+    // we are only interested in the completed readings
+    if(!isContinuous)
+        srqMask += READY_FOR_TRIGGER;
     sCommand = QString("M%1,0X").arg(srqMask);
     gpibWrite(gpibId, sCommand);   // SRQ Mask, Interrupt on Compliance
     if(isGpibError(QString(QString(Q_FUNC_INFO) + "%1").arg(sCommand)))
         exit(-1);
+#if defined(Q_OS_LINUX)
+    if(isContinuous)
+        pollTimer.start(continuousPollInterval);
+#endif
     return NO_ERROR;
 }
 
@@ -210,14 +300,317 @@ Keithley236::endVvsT() {
     gpibWrite(gpibId, "M0,0X");      // SRQ Disabled, SRQ on Compliance
     gpibWrite(gpibId, "R0");         // Disarm Trigger
     gpibWrite(gpibId, "N0X");        // Place in Stand By
+    isContinuous = false;
+    isSweeping = false;
     return NO_ERROR;
 }
 
 
-// Returns the Order of Magnitude Difference
-// between Forward and Reverse Current
+// In Delta Mode the bias is reversed after each reading and every
+// reading is combined with the previous one (of opposite sign) to
+// cancel the thermoelectric offsets. The results are notified by
+// newDeltaReading() instead of newReading().
+// Not to be used with the Continuous (Hardware Paced) mode.
+void
+Keithley236::setDeltaMode(bool bDeltaMode) {
+    bDelta = bDeltaMode;
+    deltaSign = 1.0;
+    bHaveDeltaReading = false;
+    deltaResetRequest.storeRelease(0);
+}
+
+
+// Changes the dc bias without reconfiguring the instrument.
+// In Delta Mode dNewBias is the amplitude of the reversals.
+bool
+Keithley236::setBias(double dNewBias) {
+    // A different bias amplitude may not fit in the locked range
+    if((qAbs(dNewBias) != qAbs(dBias)) && (iMeasureRange != 0)) {
+        iMeasureRange = 0;
+        if(!applyMeasureSettings())
+            return false;
+    }
+    dBias = dNewBias;
+    double dValue = bDelta ? deltaSign*dBias : dBias;
+    sCommand = QString("B%1,0,0X").arg(dValue);
+    gpibWrite(gpibId, sCommand);
+    if(isGpibError(QString(Q_FUNC_INFO) + "Error Changing the Bias"))
+        return false;
+    return true;
+}
+
+
+double
+Keithley236::getBias() {
+    return dBias;
+}
+
+
+// Forget the last reading (e.g. when the sample conditions change):
+// the next delta result will need two new readings.
+// On Windows the readings arrive in the GPIB callback thread:
+// the pairing state is reset there, at the next reading
+void
+Keithley236::resetDelta() {
+    deltaResetRequest.storeRelease(1);
+}
+
+
+// Combine the new reading with the previous one (taken at the
+// opposite bias) and reverse the bias for the next reading
+void
+Keithley236::onDeltaReading(QDateTime currentTime, QString sReading) {
+    QStringList sValues = sReading.split(",", QString::SkipEmptyParts);
+    if(sValues.count() < 2) {
+        emit sendMessage(QString(Q_FUNC_INFO) + "Reading Format Error");
+        return;
+    }
+    double dSource  = sValues.at(0).toDouble();
+    double dMeasure = sValues.at(1).toDouble();
+    if(deltaResetRequest.testAndSetOrdered(1, 0))
+        bHaveDeltaReading = false;
+    double dSign = deltaSign;
+    // Reverse the bias as soon as possible to
+    // give the sample time to settle
+    deltaSign = -deltaSign;
+    setBias(dBias);
+    if(bHaveDeltaReading) {
+        // Overlapping pairs: a result for every reading
+        double dDeltaSource  = dSign*(dSource-dLastDeltaSource)/2.0;
+        double dDeltaMeasure = dSign*(dMeasure-dLastDeltaMeasure)/2.0;
+        double dOffset       = (dMeasure+dLastDeltaMeasure)/2.0;
+        QDateTime deltaTime = lastDeltaTime.addMSecs(lastDeltaTime.msecsTo(currentTime)/2);
+        emit newDeltaReading(deltaTime, dDeltaSource, dDeltaMeasure, dOffset);
+    }
+    dLastDeltaSource  = dSource;
+    dLastDeltaMeasure = dMeasure;
+    lastDeltaTime     = currentTime;
+    bHaveDeltaReading = true;
+}
+
+
+// Selects the Filter and Integration Time used by the next
+// measures. The Adaptive profile starts from the Normal one
+// and it is then tuned by adaptSpeedProfile()
+void
+Keithley236::setSpeedProfile(int iProfile) {
+    if(iProfile == ProfileAdaptive)
+        iProfile = ProfileNormal;
+    iProfile = qBound(int(ProfilePrecise), iProfile, int(ProfileFastest));
+    iFilter       = keithley236::profileFilter[iProfile];
+    iIntegration  = keithley236::profileIntegration[iProfile];
+    iMeasureRange = 0;
+}
+
+
+// Time [s] needed to complete a single (filtered) reading
+double
+Keithley236::getReadingTime() {
+    return keithley236::filterReadings[iFilter] *
+           keithley236::integrationTime[iIntegration];
+}
+
+
+QString
+Keithley236::getSpeedSettings() {
+    return QString("Filter=%1 Integration=%2[ms] Range=%3")
+            .arg(keithley236::filterReadings[iFilter])
+            .arg(keithley236::integrationTime[iIntegration]*1000.0)
+            .arg(iMeasureRange == 0 ? QString("Auto") : QString::number(iMeasureRange));
+}
+
+
+// Returns the smallest measure range (L command code) able to
+// contain dMeasure with the required headroom
+int
+Keithley236::measureRangeFor(double dMeasure, double *pFullScale) {
+    int nRanges = rangeCount(bMeasureV);
+    int iRange;
+    for(iRange=0; iRange<nRanges-1; iRange++) {
+        if(qAbs(dMeasure) <= keithley236::rangeHeadroom*fullScale(bMeasureV, iRange))
+            break;
+    }
+    *pFullScale = fullScale(bMeasureV, iRange);
+    return iRange+1;
+}
+
+
+// Number of voltage or current ranges
+int
+Keithley236::rangeCount(bool bVoltage) {
+    return bVoltage ? 3 : 9;
+}
+
+
+// Full scale of the voltage or current range iRange (0 = lowest)
+double
+Keithley236::fullScale(bool bVoltage, int iRange) {
+    if(bVoltage)
+        return keithley236::voltageFullScale[qBound(0, iRange, 2)];
+    return keithley236::currentFullScale[qBound(0, iRange, 8)];
+}
+
+
+// Send the present Filter, Integration Time and Measure Range
+// to the instrument while it is operating in the dc mode
+bool
+Keithley236::applyMeasureSettings() {
+    double dCompliance = dMeasureCompliance;
+    if(iMeasureRange != 0) {
+        // The compliance cannot exceed the locked range
+        dCompliance = qMin(qAbs(dCompliance), fullScale(bMeasureV, iMeasureRange-1));
+    }
+    int iFunction = bMeasureV ? 1 : 0;
+    uint iErr = 0;
+    iErr |= gpibWrite(gpibId, "R0");        // Disarm Trigger
+    // As in initVvsTSourceI() the compliance must be
+    // set while in Sweep Mode
+    sCommand = QString("F%1,1X").arg(iFunction);
+    iErr |= gpibWrite(gpibId, sCommand);
+    sCommand = QString("L%1,%2X").arg(dCompliance).arg(iMeasureRange);
+    iErr |= gpibWrite(gpibId, sCommand);    // Set Compliance and Measure Range
+    sCommand = QString("F%1,0").arg(iFunction);
+    iErr |= gpibWrite(gpibId, sCommand);    // Back to dc
+    sCommand = QString("P%1").arg(iFilter);
+    iErr |= gpibWrite(gpibId, sCommand);    // Reading Filter
+    sCommand = QString("S%1").arg(iIntegration);
+    iErr |= gpibWrite(gpibId, sCommand);    // Integration time
+    iErr |= gpibWrite(gpibId, "R1X");       // Arm Trigger
+    if(iErr & ERR) {
+        QString sError;
+        sError = QString(Q_FUNC_INFO) + QString("GPIB Error in gpibWrite(): - Status= %1")
+                .arg(ThreadIbsta(), 4, 16, QChar('0'));
+        sError += ErrMsg(ThreadIbsta(), ThreadIberr(), ThreadIbcntl());
+        emit sendMessage(sError);
+        return false;
+    }
+    return true;
+}
+
+
+// Doubles the compliance (up to dMaxCompliance) while in the
+// dc mode. The measure goes back to autorange, since a locked
+// range could be the cause of the compliance.
+// Returns false if the compliance can not be raised.
+bool
+Keithley236::raiseCompliance(double dMaxCompliance) {
+    double dNewCompliance = qMin(2.0*qAbs(dMeasureCompliance), qAbs(dMaxCompliance));
+    if(dNewCompliance <= qAbs(dMeasureCompliance))
+        return false;
+    dMeasureCompliance = dNewCompliance;
+    iMeasureRange = 0;
+    return applyMeasureSettings();
+}
+
+
+double
+Keithley236::getCompliance() {
+    return dMeasureCompliance;
+}
+
+
+// Number of distinct compliance episodes since the
+// start of the present measure
 int
-Keithley236::junctionCheck(double v1, double v2) {
+Keithley236::getComplianceEvents() {
+    return iComplianceEvents;
+}
+
+
+QDateTime
+Keithley236::getComplianceStartTime() {
+    return complianceStartTime;
+}
+
+
+// Debounced compliance state
+bool
+Keithley236::isInCompliance() {
+    return bInCompliance;
+}
+
+
+// True if the last status byte read signaled compliance
+bool
+Keithley236::isReadingInCompliance() {
+    return bReadingInCompliance;
+}
+
+
+// Choose the fastest Filter and Integration Time giving the
+// required relative precision and lock the Measure Range on the
+// present measure value. dRelativeNoise must be the noise observed
+// with the present settings: it is assumed to decrease as the
+// square root of the averaging time.
+// Returns true only if the settings were changed.
+bool
+Keithley236::adaptSpeedProfile(double dRelativeNoise, double dPrecision, double dMeasure) {
+    if(dPrecision <= 0.0)
+        return false;
+    double tNow = getReadingTime();
+    double ratio = dRelativeNoise/dPrecision;
+    double tNeeded = tNow*ratio*ratio;
+    int newFilter = iFilter;
+    int newIntegration = iIntegration;
+    // Keep the present settings if they are not wasting
+    // more than a factor 4 in reading time
+    if((tNow < tNeeded) || (tNow > 4.0*tNeeded)) {
+        newFilter = 5;
+        newIntegration = 3;
+        double tBest = keithley236::filterReadings[newFilter] *
+                       keithley236::integrationTime[newIntegration];
+        // Longer integration times are preferred at equal
+        // reading time since they reject the line noise
+        for(int iS=3; iS>=0; iS--) {
+            for(int iP=0; iP<6; iP++) {
+                double t = keithley236::filterReadings[iP] *
+                           keithley236::integrationTime[iS];
+                if((t >= tNeeded) && (t < tBest)) {
+                    tBest = t;
+                    newFilter = iP;
+                    newIntegration = iS;
+                }
+            }
+        }
+    }
+    double dFullScale;
+    int newRange = measureRangeFor(dMeasure, &dFullScale);
+    if((newFilter == iFilter) &&
+       (newIntegration == iIntegration) &&
+       (newRange == iMeasureRange))
+        return false;
+    iFilter = newFilter;
+    iIntegration = newIntegration;
+    iMeasureRange = newRange;
+    return applyMeasureSettings();
+}
+
+
+// Starts the check of a single pair of bias values.
+// The result is notified by junctionCheckResult()
+bool
+Keithley236::junctionCheck(double v1, double v2, double currentCompliance) {
+    QVector<QPair<double, double>> biasPairs;
+    biasPairs.append(qMakePair(v1, v2));
+    return startJunctionCheck(biasPairs, currentCompliance, 30000);
+}
+
+
+// Starts the asynchronous measure of the Reverse (first value)
+// and Forward (second value) currents for each pair of bias.
+// Every pair is notified by junctionCheckResult() and the end
+// of the check (or its failure) by junctionCheckDone().
+// The whole check must end within iTimeout ms.
+bool
+Keithley236::startJunctionCheck(QVector<QPair<double, double>> biasPairs,
+                                double currentCompliance,
+                                int iTimeout) {
+    if(jState != JunctionIdle) {
+        emit sendMessage(QString(Q_FUNC_INFO) + "Junction Check already running");
+        return false;
+    }
+    if(biasPairs.isEmpty())
+        return false;
     uint iErr = 0;
     iErr |= gpibWrite(gpibId, "M0,0X");    // SRQ Disabled, SRQ on Compliance
     iErr |= gpibWrite(gpibId, "F0,0");     // Source V Measure I dc
@@ -227,80 +620,151 @@ Keithley236::junctionCheck(double v1, double v2) {
     iErr |= gpibWrite(gpibId, "S3");       // 20ms integration time
     iErr |= gpibWrite(gpibId, "R0X");      // Disarm Trigger
     iErr |= gpibWrite(gpibId, "T0,1,0,0"); // Trigger on X ^SRC DLY MSR
-    iErr |= gpibWrite(gpibId, "L1.0e-4,0");// Set Compliance, Autorange Measure
+    sCommand = QString("L%1,0X").arg(currentCompliance);
+    iErr |= gpibWrite(gpibId, sCommand);   // Set Compliance, Autorange Measure
     iErr |= gpibWrite(gpibId, "G4,2,0");   // Output Only Measure, No Prefix, Single Line
     iErr |= gpibWrite(gpibId, "R1");       // Arm Trigger
-
-    // Get the reverse current value
-    sCommand = QString("B%1,0,1000").arg(v1, 6, 'g');
-    //  qDebug() << sCommand;
-    iErr |= gpibWrite(gpibId, sCommand);   // Source initial Voltage Measure I Autorange
-    iErr |= gpibWrite(gpibId, "N1X");      // Operate !
     if(iErr & ERR) {
         QString sError;
         sError = QString(Q_FUNC_INFO) + QString("GPIB Error in gpibWrite(): - Status= %1")
                 .arg(ThreadIbsta(), 4, 16, QChar('0'));
         sError += ErrMsg(ThreadIbsta(), ThreadIberr(), ThreadIbcntl());
         emit sendMessage(sError);
-        return ERROR_JUNCTION;
+        resetJunctionCheck();
+        return false;
     }
-    // Rischio di loop infinito
-    ibrsp(gpibId, &spollByte);
-    while(!(spollByte & READY_FOR_TRIGGER)) {// Ready for trigger
-        QThread::msleep(100);
-        ibrsp(gpibId, &spollByte);
+    junctionBias = biasPairs;
+    iJunctionPair = 0;
+    // Get the first reverse current value
+    if(!setJunctionBias(junctionBias.at(iJunctionPair).first)) {
+        resetJunctionCheck();
+        return false;
     }
-    gpibWrite(gpibId, "H0X");
-    if(isGpibError(QString(Q_FUNC_INFO) + "Trigger Error"))
-        return ERROR_JUNCTION;
-    // Rischio di loop infinito
-    ibrsp(gpibId, &spollByte);
-    while(!(spollByte & READING_DONE)) {// Reading Done
-        QThread::msleep(100);
-        ibrsp(gpibId, &spollByte);
+    gpibWrite(gpibId, "N1X");              // Operate !
+    if(isGpibError(QString(Q_FUNC_INFO) + "Placing Keithely 236 in Operate Mode")) {
+        resetJunctionCheck();
+        return false;
     }
-    sResponse = gpibRead(gpibId);
-    double I_Reverse = sResponse.toDouble();
+    sCommand = QString("M%1,0X").arg(K236_ERROR + READY_FOR_TRIGGER + READING_DONE);
+    gpibWrite(gpibId, sCommand);           // SRQ on Ready for Trigger and Reading Done
+    if(isGpibError(QString(Q_FUNC_INFO) + "Error enabling SRQ Mask")) {
+        resetJunctionCheck();
+        return false;
+    }
+    jState = JunctionReverseReady;
+    junctionTimer.start(iTimeout);
+#if defined(Q_OS_LINUX)
+    pollTimer.start(junctionPollInterval);
+#endif
+    return true;
+}
+
+
+void
+Keithley236::abortJunctionCheck() {
+    if(jState != JunctionIdle)
+        endJunctionCheck(false);
+}
+
 
-    // Get the forward current value
-    sCommand = QString("B%1,0,1000").arg(v2, 6, 'g');
-    //  qDebug() << sCommand;
-    iErr |= gpibWrite(gpibId, sCommand);   // Source final Voltage Measure I Autorange
+bool
+Keithley236::setJunctionBias(double dVoltage) {
+    sCommand = QString("B%1,0,1000").arg(dVoltage, 6, 'g');
+    gpibWrite(gpibId, sCommand);   // Source Voltage Measure I Autorange
     if(isGpibError(QString(Q_FUNC_INFO) + "Error Changing Output Voltage"))
-        return ERROR_JUNCTION;
-    // Rischio di loop infinito
-    ibrsp(gpibId, &spollByte);
-    while(!(spollByte & READY_FOR_TRIGGER)) {// Ready for trigger
-        QThread::msleep(100);
-        ibrsp(gpibId, &spollByte);
-    }
-    gpibWrite(gpibId, "H0X");
-    if(isGpibError(QString(Q_FUNC_INFO) + "Trigger Error"))
-        return ERROR_JUNCTION;
-    // Rischio di loop infinito
-    ibrsp(gpibId, &spollByte);
-    while(!(spollByte & READING_DONE)) {// Reading Done
-        QThread::msleep(100);
-        ibrsp(gpibId, &spollByte);
+        return false;
+    return true;
+}
+
+
+// Advances the Junction Check state machine
+// on each relevant status byte event
+void
+Keithley236::onJunctionCheckEvent() {
+    switch(jState) {
+    case JunctionReverseReady:
+    case JunctionForwardReady:
+        if(!(spollByte & READY_FOR_TRIGGER))
+            return;
+        gpibWrite(gpibId, "H0X");
+        if(isGpibError(QString(Q_FUNC_INFO) + "Trigger Error")) {
+            endJunctionCheck(false);
+            return;
+        }
+        jState = (jState == JunctionReverseReady) ? JunctionReverseReading
+                                                  : JunctionForwardReading;
+        break;
+    case JunctionReverseReading:
+        if(!(spollByte & READING_DONE))
+            return;
+        dReverseCurrent = gpibRead(gpibId).toDouble();
+        // Get the forward current value
+        if(!setJunctionBias(junctionBias.at(iJunctionPair).second)) {
+            endJunctionCheck(false);
+            return;
+        }
+        jState = JunctionForwardReady;
+        break;
+    case JunctionForwardReading:
+        if(!(spollByte & READING_DONE))
+            return;
+        emit junctionCheckResult(junctionBias.at(iJunctionPair).first,
+                                 dReverseCurrent,
+                                 junctionBias.at(iJunctionPair).second,
+                                 gpibRead(gpibId).toDouble());
+        iJunctionPair++;
+        if(iJunctionPair >= junctionBias.count()) {
+            endJunctionCheck(true);
+            return;
+        }
+        // Get the next reverse current value
+        if(!setJunctionBias(junctionBias.at(iJunctionPair).first)) {
+            endJunctionCheck(false);
+            return;
+        }
+        jState = JunctionReverseReady;
+        break;
+    default:
+        break;
     }
-    sResponse = gpibRead(gpibId);
-    double I_Forward = sResponse.toDouble();
+}
+
+
+void
+Keithley236::onJunctionCheckTimeout() {
+    emit sendMessage(QString(Q_FUNC_INFO) + "Junction Check Timeout");
+    abortJunctionCheck();
+}
+
+
+void
+Keithley236::endJunctionCheck(bool bSuccess) {
+    if(!resetJunctionCheck())
+        bSuccess = false;
+    emit junctionCheckDone(bSuccess);
+}
+
+
+// Stops the Junction Check and places the Keithley 236
+// in Standby with the SRQ disabled.
+// Returns false on GPIB errors
+bool
+Keithley236::resetJunctionCheck() {
+    bool bSuccess = true;
+    junctionTimer.stop();
+    jState = JunctionIdle;
+#if defined(Q_OS_LINUX)
+    if(pollTimer.isActive())
+        pollTimer.start(pollInterval);
+#endif
+    gpibWrite(gpibId, "M0,0X");    // SRQ Disabled
     gpibWrite(gpibId, "B0.0,0,0"); // Source 0.0V Measure I Autorange
     if(isGpibError(QString(Q_FUNC_INFO) + "Zeroing Output Voltage"))
-        return ERROR_JUNCTION;
+        bSuccess = false;
     gpibWrite(gpibId, "N0X");      // Stand By !
     if(isGpibError(QString(Q_FUNC_INFO) + "Placing Keithely 236 in Standby Mode"))
-        return ERROR_JUNCTION;
-    if((I_Forward == 0.0) || (I_Reverse == 0.0))
-        return ERROR_JUNCTION;
-
-    //  qDebug() << I_Forward << I_Reverse;
-    //  qDebug() << "Diff="
-    //           << qRound(log10(fabs(I_Forward))) -
-    //              qRound(log10(fabs(I_Reverse)));
-
-    return qRound(log10(fabs(I_Forward))) -
-            qRound(log10(fabs(I_Reverse)));
+        bSuccess = false;
+    return bSuccess;
 }
 
 
@@ -319,6 +783,10 @@ Keithley236::initISweep(double startCurrent,
     iErr |= gpibWrite(gpibId, sCommand);   // Set Compliance, Autorange Measure
     iErr |= gpibWrite(gpibId, "G5,2,2");   // Output Source and Measure, No Prefix, All Lines Sweep Data
     iErr |= gpibWrite(gpibId, "Z0");       // Disable suppression
+    sCommand = QString("P%1").arg(iFilter);
+    iErr |= gpibWrite(gpibId, sCommand);   // Reading Filter
+    sCommand = QString("S%1").arg(iIntegration);
+    iErr |= gpibWrite(gpibId, sCommand);   // Integration time
     sCommand = QString("Q1,%1,%2,%3,0,%4X")
             .arg(startCurrent)
             .arg(stopCurrent)
@@ -367,6 +835,10 @@ Keithley236::initVSweep(double startVoltage,
     iErr |= gpibWrite(gpibId, sCommand);   // Set Compliance, Autorange Measure
     iErr |= gpibWrite(gpibId, "G5,2,2");   // Output Source and Measure, No Prefix, All Lines Sweep Data
     iErr |= gpibWrite(gpibId, "Z0");       // Disable suppression
+    sCommand = QString("P%1").arg(iFilter);
+    iErr |= gpibWrite(gpibId, sCommand);   // Reading Filter
+    sCommand = QString("S%1").arg(iIntegration);
+    iErr |= gpibWrite(gpibId, sCommand);   // Integration time
     sCommand = QString("Q1,%1,%2,%3,0,%4X")
             .arg(startVoltage)
             .arg(stopVoltage)
@@ -400,6 +872,182 @@ Keithley236::initVSweep(double startVoltage,
 }
 
 
+// Programs a group of segments sharing the source type and the
+// compliance: the first one with a Linear Stair sweep (Q1 or the
+// pulsed Q4) and the others appended (Q7 or Q10) so that they run
+// back to back in the sweep buffer with a single trigger
+bool
+Keithley236::initSweepProgram(QVector<SweepSegment> segments) {
+    if(segments.isEmpty())
+        return false;
+    int nPoints = 0;
+    for(int i=0; i<segments.count(); i++) {
+        if(!segments.at(i).isCompatible(segments.at(0))) {
+            emit sendMessage(QString(Q_FUNC_INFO) + "Incompatible Sweep Segments");
+            return false;
+        }
+        nPoints += segments.at(i).points();
+    }
+    if(nPoints > MAX_SWEEP_POINTS) {
+        emit sendMessage(QString(Q_FUNC_INFO) +
+                         QString("Too many Sweep Points: %1").arg(nPoints));
+        return false;
+    }
+    uint iErr = 0;
+    iErr |= gpibWrite(gpibId, "M0,0X");    // SRQ Disabled, SRQ on Compliance
+    if(segments.at(0).bSourceI)
+        iErr |= gpibWrite(gpibId, "F1,1"); // Source I, Sweep mode
+    else
+        iErr |= gpibWrite(gpibId, "F0,1"); // Source V, Sweep mode
+    iErr |= gpibWrite(gpibId, "O1");       // Remote Sense
+    iErr |= gpibWrite(gpibId, "T1,0,0,0"); // Trigger on GET, Continuous
+    sCommand = QString("L%1,0X").arg(segments.at(0).dCompliance);
+    iErr |= gpibWrite(gpibId, sCommand);   // Set Compliance, Autorange Measure
+    iErr |= gpibWrite(gpibId, "G5,2,2");   // Output Source and Measure, No Prefix, All Lines Sweep Data
+    iErr |= gpibWrite(gpibId, "Z0");       // Disable suppression
+    sCommand = QString("P%1").arg(iFilter);
+    iErr |= gpibWrite(gpibId, sCommand);   // Reading Filter
+    sCommand = QString("S%1").arg(iIntegration);
+    iErr |= gpibWrite(gpibId, sCommand);   // Integration time
+    for(int i=0; i<segments.count(); i++) {
+        if(segments.at(i).bPulsed) {
+            // Linear Stair Pulsed sweep (Q4) or its Append (Q10)
+            sCommand = QString("Q%1,%2,%3,%4,0,%5,%6X")
+                    .arg(i == 0 ? 4 : 10)
+                    .arg(segments.at(i).dStart)
+                    .arg(segments.at(i).dStop)
+                    .arg(segments.at(i).dStep)
+                    .arg(segments.at(i).dTon)
+                    .arg(segments.at(i).dToff);
+        }
+        else {
+            // Linear Stair sweep (Q1) or its Append (Q7)
+            sCommand = QString("Q%1,%2,%3,%4,0,%5X")
+                    .arg(i == 0 ? 1 : 7)
+                    .arg(segments.at(i).dStart)
+                    .arg(segments.at(i).dStop)
+                    .arg(segments.at(i).dStep)
+                    .arg(segments.at(i).dDelay);
+        }
+        iErr |= gpibWrite(gpibId, sCommand);// Program (or Append) Sweep
+    }
+    if(iErr & ERR) {
+        QString sError;
+        sError = QString(Q_FUNC_INFO) + QString("GPIB Error in gpibWrite(): - Status= %1")
+                .arg(ThreadIbsta(), 4, 16, QChar('0'));
+        sError += ErrMsg(ThreadIbsta(), ThreadIberr(), ThreadIbcntl());
+        emit sendMessage(sError);
+        return false;
+    }
+    iErr  = gpibWrite(gpibId, "R1");       // Arm Trigger
+    iErr |= gpibWrite(gpibId, "N1X");      // Operate !
+    if(iErr & ERR) {
+        QString sError;
+        sError = QString(Q_FUNC_INFO) + QString("GPIB Error in gpibWrite(): - Status= %1")
+                .arg(ThreadIbsta(), 4, 16, QChar('0'));
+        sError += ErrMsg(ThreadIbsta(), ThreadIberr(), ThreadIbcntl());
+        emit sendMessage(sError);
+        return false;
+    }
+    sCommand = QString("M%1,0X").arg(COMPLIANCE + SWEEP_DONE + READY_FOR_TRIGGER);
+    gpibWrite(gpibId, sCommand);   // SRQ On Sweep Done
+    if(isGpibError(QString(Q_FUNC_INFO) + "Error enabling SRQ Mask"))
+        return false;
+    isSweeping = true;
+    return true;
+}
+
+
+// A Fixed Level Sweep of nPoints is used as a reading buffer:
+// the whole buffer is transferred at once on Sweep Done.
+// dSource is a current (bSourceI) or a voltage and dCompliance
+// the corresponding voltage or current compliance
+bool
+Keithley236::initBurst(bool bSourceI,
+                       double dSource,
+                       int nPoints,
+                       double delay,
+                       double dCompliance) {
+    nPoints = qBound(1, nPoints, MAX_SWEEP_POINTS);
+    uint iErr = 0;
+    iErr |= gpibWrite(gpibId, "M0,0X");    // SRQ Disabled, SRQ on Compliance
+    if(bSourceI)
+        iErr |= gpibWrite(gpibId, "F1,1"); // Source I, Sweep mode
+    else
+        iErr |= gpibWrite(gpibId, "F0,1"); // Source V, Sweep mode
+    iErr |= gpibWrite(gpibId, "O1");       // Remote Sense
+    iErr |= gpibWrite(gpibId, "T1,0,0,0"); // Trigger on GET, Continuous
+    sCommand = QString("L%1,0X").arg(dCompliance);
+    iErr |= gpibWrite(gpibId, sCommand);   // Set Compliance, Autorange Measure
+    iErr |= gpibWrite(gpibId, "G5,2,2");   // Output Source and Measure, No Prefix, All Lines Sweep Data
+    iErr |= gpibWrite(gpibId, "Z0");       // Disable suppression
+    sCommand = QString("P%1").arg(keithley236::burstFilter);
+    iErr |= gpibWrite(gpibId, sCommand);   // No Filter
+    sCommand = QString("S%1").arg(keithley236::burstIntegration);
+    iErr |= gpibWrite(gpibId, sCommand);   // 4ms integration time
+    sCommand = QString("Q0,%1,0,%2,%3X")
+            .arg(dSource)
+            .arg(delay)
+            .arg(nPoints);
+    iErr |= gpibWrite(gpibId, sCommand);   // Program Fixed Level Sweep
+    if(iErr & ERR) {
+        QString sError;
+        sError = QString(Q_FUNC_INFO) + QString("GPIB Error in gpibWrite(): - Status= %1")
+                .arg(ThreadIbsta(), 4, 16, QChar('0'));
+        sError += ErrMsg(ThreadIbsta(), ThreadIberr(), ThreadIbcntl());
+        emit sendMessage(sError);
+        return false;
+    }
+    // Time needed by each point of the burst [s]
+    burstPeriod = getBurstPeriod(delay);
+    iErr  = gpibWrite(gpibId, "R1");       // Arm Trigger
+    iErr |= gpibWrite(gpibId, "N1X");      // Operate !
+    if(iErr & ERR) {
+        QString sError;
+        sError = QString(Q_FUNC_INFO) + QString("GPIB Error in gpibWrite(): - Status= %1")
+                .arg(ThreadIbsta(), 4, 16, QChar('0'));
+        sError += ErrMsg(ThreadIbsta(), ThreadIberr(), ThreadIbcntl());
+        emit sendMessage(sError);
+        return false;
+    }
+    sCommand = QString("M%1,0X").arg(COMPLIANCE + SWEEP_DONE + READY_FOR_TRIGGER);
+    gpibWrite(gpibId, sCommand);   // SRQ On Sweep Done
+    if(isGpibError(QString(Q_FUNC_INFO) + "Error enabling SRQ Mask"))
+        return false;
+    isSweeping = true;
+    return true;
+}
+
+
+// Returns the nominal time [s] between two points of a burst
+double
+Keithley236::getBurstPeriod() {
+    return burstPeriod;
+}
+
+
+// Time [s] that each point of a burst with the given delay [ms] will need
+double
+Keithley236::getBurstPeriod(double delay) {
+    return delay/1000.0 +
+           keithley236::filterReadings[keithley236::burstFilter] *
+           keithley236::integrationTime[keithley236::burstIntegration];
+}
+
+
+// Prepare the instrument to repeat the already programmed
+// sweep without sending again the whole configuration
+bool
+Keithley236::rearmSweep() {
+    gpibWrite(gpibId, "R0");         // Disarm Trigger
+    gpibWrite(gpibId, "R1X");        // Arm Trigger
+    if(isGpibError(QString(Q_FUNC_INFO) + "Error Arming Trigger"))
+        return false;
+    isSweeping = true;
+    return true;
+}
+
+
 int
 Keithley236::stopSweep() {
 #if defined(Q_OS_LINUX)
@@ -428,13 +1076,39 @@ Keithley236::onGpibCallback(int LocalUd, unsigned long LocalIbsta, unsigned long
         emit sendMessage(QString(Q_FUNC_INFO) + QString("GPIB error %1").arg(LocalIberr));
     }
 
-    if(spollByte & COMPLIANCE) {// Compliance
-        iComplianceEvents++;
-        emit complianceEvent();
-        QThread::msleep(300);
+    if(jState != JunctionIdle) {
+        if(spollByte & K236_ERROR) {// Error
+            gpibWrite(LocalUd, "U1X");
+            sCommand = gpibRead(LocalUd);
+            emit sendMessage(QString(Q_FUNC_INFO) + QString("Error ")+ sCommand);
+            endJunctionCheck(false);
+        }
+        else
+            onJunctionCheckEvent();
+        keithley236::rearmMask = RQS;
+        return;
     }
-    else
+
+    // Compliance is notified only when it starts and when
+    // it is over: a compliance storm does not flood the
+    // event loop and nothing is waiting here
+    QDateTime statusTime = QDateTime::currentDateTime();
+    bReadingInCompliance = (spollByte & COMPLIANCE) != 0;
+    if(bReadingInCompliance) {// Compliance
+        lastComplianceTime = statusTime;
+        if(!bInCompliance) {
+            bInCompliance = true;
+            complianceStartTime = statusTime;
+            iComplianceEvents++;
+            emit complianceEvent();
+        }
+    }
+    else if(bInCompliance &&
+            (lastComplianceTime.msecsTo(statusTime) >= complianceDebounce))
+    {
+        bInCompliance = false;
         emit clearCompliance();
+    }
 
     if(spollByte & K236_ERROR) {// Error
         gpibWrite(LocalUd, "U1X");
@@ -471,7 +1145,10 @@ Keithley236::onGpibCallback(int LocalUd, unsigned long LocalIbsta, unsigned long
         sResponse = gpibRead(LocalUd);
         if(sResponse != QString()) {
             QDateTime currentTime = QDateTime::currentDateTime();
-            emit newReading(currentTime, sResponse);
+            if(bDelta)
+                onDeltaReading(currentTime, sResponse);
+            else
+                emit newReading(currentTime, sResponse);
         }
     }
 
@@ -490,6 +1167,7 @@ Keithley236::isReadyForTrigger() {
 
 bool
 Keithley236::sendTrigger() {
+    triggerTime = QDateTime::currentDateTime();
     ibtrg(gpibId);
     if(isGpibError(QString(Q_FUNC_INFO) + "Trigger Error"))
         return false;
@@ -497,6 +1175,12 @@ Keithley236::sendTrigger() {
 }
 
 
+QDateTime
+Keithley236::getTriggerTime() {
+    return triggerTime;
+}
+
+
 void
 Keithley236::checkNotify() {
 #if defined(Q_OS_LINUX)
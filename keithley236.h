@@ -23,7 +23,11 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <QObject>
 #include <QDateTime>
 #include <QTimer>
+#include <QVector>
+#include <QPair>
+#include <QAtomicInteger>
 #include "gpibdevice.h"
+#include "sweepprogram.h"
 
 
 class Keithley236 : public GpibDevice
@@ -34,15 +38,40 @@ public:
     explicit Keithley236(int gpio, int address, QObject *parent = Q_NULLPTR);
     virtual ~Keithley236();
     int      init();
-    int      initVvsTSourceI(double dAppliedCurrent, double dCompliance);
-    int      initVvsTSourceV(double dAppliedVoltage, double dCompliance);
+    int      initVvsTSourceI(double dAppliedCurrent, double dCompliance, bool bContinuous);
+    int      initVvsTSourceV(double dAppliedVoltage, double dCompliance, bool bContinuous);
     int      endVvsT();
+    void     setDeltaMode(bool bDeltaMode);
+    bool     setBias(double dNewBias);
+    double   getBias();
+    void     resetDelta();
+    static int    rangeCount(bool bVoltage);
+    static double fullScale(bool bVoltage, int iRange);
+    void     setSpeedProfile(int iProfile);
+    bool     applyMeasureSettings();
+    bool     adaptSpeedProfile(double dRelativeNoise, double dPrecision, double dMeasure);
+    double   getReadingTime();
+    QString  getSpeedSettings();
+    bool     raiseCompliance(double dMaxCompliance);
+    double   getCompliance();
+    int      getComplianceEvents();
+    QDateTime getComplianceStartTime();
+    bool     isInCompliance();
+    bool     isReadingInCompliance();
     void     onGpibCallback(int ud, unsigned long ibsta, unsigned long iberr, long ibcntl);
-    int      junctionCheck(double v1, double v2);
+    bool     junctionCheck(double v1, double v2, double currentCompliance);
+    bool     startJunctionCheck(QVector<QPair<double, double>> biasPairs, double currentCompliance, int iTimeout);
+    void     abortJunctionCheck();
     bool     initISweep(double startCurrent, double stopCurrent, double currentStep, double delay, double voltageCompliance);
     bool     initVSweep(double startVoltage, double stopVoltage, double voltageStep, double delay, double currentCompliance);
+    bool     initSweepProgram(QVector<SweepSegment> segments);
+    bool     initBurst(bool bSourceI, double dSource, int nPoints, double delay, double dCompliance);
+    double   getBurstPeriod();
+    double   getBurstPeriod(double delay);
+    bool     rearmSweep();
     int      stopSweep();
     bool     sendTrigger();
+    QDateTime getTriggerTime();
     bool     triggerSweep();
     bool     isReadyForTrigger();
 
@@ -51,12 +80,48 @@ signals:
     void     clearCompliance();
     void     readyForTrigger();
     void     newReading(QDateTime currentTime, QString sReading);
+    void     newDeltaReading(QDateTime currentTime, double dSource, double dMeasure, double dOffset);
     void     sweepDone(QDateTime currentTime, QString sSweepData);
+    void     junctionCheckResult(double vReverse, double iReverse, double vForward, double iForward);
+    void     junctionCheckDone(bool bSuccess);
 
 public slots:
     void checkNotify();
 
+protected slots:
+    void onJunctionCheckTimeout();
+
 protected:
+    void onJunctionCheckEvent();
+    bool setJunctionBias(double dVoltage);
+    void endJunctionCheck(bool bSuccess);
+    bool resetJunctionCheck();
+    int  measureRangeFor(double dMeasure, double *pFullScale);
+    void onDeltaReading(QDateTime currentTime, QString sReading);
+
+    enum junctionState {
+        JunctionIdle           = 0,
+        JunctionReverseReady   = 1,
+        JunctionReverseReading = 2,
+        JunctionForwardReady   = 3,
+        JunctionForwardReading = 4
+    };
+
+public:
+    enum speedProfile {
+        ProfilePrecise  = 0,
+        ProfileNormal   = 1,
+        ProfileFast     = 2,
+        ProfileFastest  = 3,
+        ProfileAdaptive = 4
+    };
+    // What to do when the compliance is reached
+    enum compliancePolicy {
+        ComplianceContinue = 0,
+        ComplianceRaise    = 1,
+        ComplianceSkip     = 2,
+        ComplianceAbort    = 3
+    };
 
 public:
     const int ERROR_JUNCTION;
@@ -70,10 +135,46 @@ public:
     const int K236_ERROR;
     const int COMPLIANCE;
 
+    const int MAX_SWEEP_POINTS;
+    const int MAX_COMPLIANCE_EVENTS;
+
 
 private:
     bool   bStop;
     int    iComplianceEvents;
+    // Debounced compliance state
+    bool   bInCompliance;
+    bool   bReadingInCompliance;
+    int    complianceDebounce;
+    QDateTime complianceStartTime;
+    QDateTime lastComplianceTime;
     double lastReading;
     bool   isSweeping;
+    bool   isContinuous;
+    int    continuousPollInterval;
+    double burstPeriod;
+    QDateTime triggerTime;
+    // Measure speed settings
+    int    iFilter;
+    int    iIntegration;
+    int    iMeasureRange;
+    double dMeasureCompliance;
+    bool   bMeasureV;
+    // Delta mode (bias reversal) state
+    bool   bDelta;
+    double dBias;
+    double deltaSign;
+    bool   bHaveDeltaReading;
+    // Set from the GUI, consumed in the reading callback
+    QAtomicInteger<int> deltaResetRequest;
+    double dLastDeltaSource;
+    double dLastDeltaMeasure;
+    QDateTime lastDeltaTime;
+    // Junction Check state machine
+    junctionState jState;
+    QVector<QPair<double, double>> junctionBias;
+    int    iJunctionPair;
+    double dReverseCurrent;
+    int    junctionPollInterval;
+    QTimer junctionTimer;
 };
@@ -21,11 +21,14 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <QtGlobal>
 //#include <QDebug>
 #include <QThread>
+#include <QMutexLocker>
 
 
 namespace
 lakeshore330 {
     static int rearmMask;
+    // Longest wait [ms] for the bus in the periodic GUI commands
+    static const int busWait = 100;
 #if !defined(Q_OS_LINUX)
     int __stdcall
     myCallback(int LocalUd, unsigned long LocalIbsta, unsigned long LocalIberr, long LocalIbcntl, void* callbackData) {
@@ -52,6 +55,7 @@ LakeShore330::LakeShore330(int gpio, int address, QObject *parent)
     , DDE(8)  // Device Dependent Error
     , QYE(4)  // Query Error
     , OPC(1)  // Operation Complete
+    , busMutex(QMutex::Recursive)
 {
     pollInterval = 659;
     Q_UNUSED(lakeshore330::rearmMask);
@@ -72,6 +76,7 @@ LakeShore330::~LakeShore330() {
 
 int
 LakeShore330::init() {
+    QMutexLocker locker(&busMutex);
     gpibId = ibdev(gpibNumber, gpibAddress, 0, T10s, 1, 0);
     if(gpibId < 0) {
         QString sError = QString(Q_FUNC_INFO) + ErrMsg(ThreadIbsta(), ThreadIberr(), ThreadIbcntl());
@@ -126,6 +131,7 @@ LakeShore330::init() {
 
 void
 LakeShore330::onGpibCallback(int LocalUd, unsigned long LocalIbsta, unsigned long LocalIberr, long LocalIbcntl) {
+    QMutexLocker locker(&busMutex);
     Q_UNUSED(LocalUd)
     Q_UNUSED(LocalIbsta)
     Q_UNUSED(LocalIberr)
@@ -173,13 +179,14 @@ LakeShore330::onGpibCallback(int LocalUd, unsigned long LocalIbsta, unsigned lon
         emit sendMessage(QString(Q_FUNC_INFO) + "Control Data Ready");
     }
     if(spollByte & SDR) {
-        emit sendMessage(QString(Q_FUNC_INFO) + "Sample Data Ready");
+        emit sampleDataReady();
     }
 }
 
 
 double
 LakeShore330::getTemperature() {
+    QMutexLocker locker(&busMutex);
     gpibWrite(gpibId, "SDAT?\r\n");// Query the Sample Sensor Data.
     if(isGpibError(QString(Q_FUNC_INFO) + "SDAT? Failed"))
         return 0.0;
@@ -192,6 +199,7 @@ LakeShore330::getTemperature() {
 
 bool
 LakeShore330::setTemperature(double Temperature) {
+    QMutexLocker locker(&busMutex);
     //qDebug() << QString("LakeShore330::setTemperature(%1)").arg(Temperature);
     if(Temperature < 0.0 || Temperature > 900.0) return false;
     sCommand = QString("SETP %1\r\n").arg(Temperature, 0, 'f', 2);
@@ -204,6 +212,7 @@ LakeShore330::setTemperature(double Temperature) {
 
 bool
 LakeShore330::switchPowerOn(int iRange) {
+    QMutexLocker locker(&busMutex);
     // Sets heater status: 1 = low, 2 = medium, 3 = high.
     gpibWrite(gpibId, QString("RANG %1\r\n").arg(iRange));
     if(isGpibError(QString(Q_FUNC_INFO) + QString("switchPowerOn(%1): Failed").arg(iRange)))
@@ -216,8 +225,32 @@ LakeShore330::switchPowerOn(int iRange) {
 }
 
 
+// The periodic commands from the GUI give up (returning false)
+// instead of blocking while the sampler thread is on the bus.
+// They will be repeated at the next tick
+bool
+LakeShore330::trySetTemperature(double Temperature) {
+    if(!busMutex.tryLock(lakeshore330::busWait))
+        return false;
+    bool bResult = setTemperature(Temperature);
+    busMutex.unlock();
+    return bResult;
+}
+
+
+bool
+LakeShore330::trySwitchPowerOn(int iRange) {
+    if(!busMutex.tryLock(lakeshore330::busWait))
+        return false;
+    bool bResult = switchPowerOn(iRange);
+    busMutex.unlock();
+    return bResult;
+}
+
+
 bool
 LakeShore330::switchPowerOff() {
+    QMutexLocker locker(&busMutex);
     //qDebug() << "LakeShore330::switchPowerOff()";
     gpibWrite(gpibId, "*SRE 0\r\n");// Set Service Request Enable to No SRQ
     // Sets heater status: 0 = off.
@@ -230,6 +263,7 @@ LakeShore330::switchPowerOff() {
 
 bool
 LakeShore330::startRamp(double targetT, double rate) {
+    QMutexLocker locker(&busMutex);
     sCommand = QString("RAMPR %1\r\n").arg(rate);
     gpibWrite(gpibId, sCommand);
     if(isGpibError(QString(Q_FUNC_INFO) + "Unable to set Ramp Rate"))
@@ -238,9 +272,11 @@ LakeShore330::startRamp(double targetT, double rate) {
         return false;
     sCommand = QString("RAMP 1\r\n");
     gpibWrite(gpibId, sCommand);
-    QThread::sleep(1);
     if(isGpibError(QString(Q_FUNC_INFO) + "Unable to Start Ramp"))
         return false;
+    // Wait for the Thermostat without holding the bus
+    locker.unlock();
+    QThread::sleep(1);
     //qDebug() << QString("LakeShore330::startRamp(%1)").arg(rate);
     return true;
 }
@@ -248,17 +284,21 @@ LakeShore330::startRamp(double targetT, double rate) {
 
 bool
 LakeShore330::stopRamp() {
+    QMutexLocker locker(&busMutex);
     sCommand = QString("RAMP 0\r\n");
     gpibWrite(gpibId, sCommand);
-    QThread::sleep(1);
     if(isGpibError(QString(Q_FUNC_INFO) + "Unable to Stop Ramp"))
         return false;
+    // Wait for the Thermostat without holding the bus
+    locker.unlock();
+    QThread::sleep(1);
     return true;
 }
 
 
 bool
 LakeShore330::isRamping() {
+    QMutexLocker locker(&busMutex);
     sCommand = QString("RAMPS?\r\n");
     gpibWrite(gpibId, sCommand);
     if(isGpibError(QString(Q_FUNC_INFO) + "Unable to query Ramp Status"))
@@ -272,12 +312,87 @@ LakeShore330::isRamping() {
 }
 
 
+// A Service Request for each new reading of the Sample Sensor
+bool
+LakeShore330::setSampleDataSRQ(bool bEnable) {
+    QMutexLocker locker(&busMutex);
+    gpibWrite(gpibId, QString("*SRE %1\r\n").arg(bEnable ? SDR : 0));
+    if(isGpibError(QString(Q_FUNC_INFO) + "*SRE Failed"))
+        return false;
+    return true;
+}
+
+
+// Zone parameters used when the autotuning is set to "Zone" (TUNE 4).
+// iZone in [1:10], dTopT is the upper set point limit of the zone.
+bool
+LakeShore330::setZone(int iZone, double dTopT, int iRange, double dP, double dI, double dD) {
+    QMutexLocker locker(&busMutex);
+    sCommand = QString("ZONE %1,%2,%3,%4,%5,%6\r\n")
+               .arg(iZone)
+               .arg(dTopT, 0, 'f', 1)
+               .arg(iRange)
+               .arg(dP, 0, 'f', 1)
+               .arg(dI, 0, 'f', 1)
+               .arg(dD, 0, 'f', 0);
+    gpibWrite(gpibId, sCommand);
+    if(isGpibError(QString(Q_FUNC_INFO) + QString("ZONE %1 Failed").arg(iZone)))
+        return false;
+    return true;
+}
+
+
+// Sends all the queries in a single message (separated by
+// semicolons) and splits the combined reply. Returns an empty
+// list if the number of replies does not match
+QStringList
+LakeShore330::query(QStringList sQueries) {
+    QMutexLocker locker(&busMutex);
+    sCommand = sQueries.join(";") + QString("\r\n");
+    gpibWrite(gpibId, sCommand);
+    if(isGpibError(QString(Q_FUNC_INFO) + sQueries.join(";") + " Failed"))
+        return QStringList();
+    sResponse = gpibRead(gpibId);
+    if(isGpibError(QString(Q_FUNC_INFO) + "Unable to read the replies"))
+        return QStringList();
+    QStringList sReplies = sResponse.split(";");
+    if(sReplies.count() != sQueries.count()) {
+        emit sendMessage(QString(Q_FUNC_INFO) + QString("Unexpected reply: %1").arg(sResponse));
+        return QStringList();
+    }
+    for(int i=0; i<sReplies.count(); i++)
+        sReplies[i] = sReplies.at(i).trimmed();
+    return sReplies;
+}
+
+
+// Sample and Control temperatures, Ramp status and
+// Heater status in a single bus transaction
+bool
+LakeShore330::getStatus(Status* pStatus) {
+    QStringList sReplies = query(QStringList() << "SDAT?" << "CDAT?"
+                                               << "RAMPS?" << "RANG?" << "HEAT?");
+    if(sReplies.isEmpty())
+        return false;
+    bool bOk[5];
+    pStatus->sampleT      = sReplies.at(0).toDouble(&bOk[0]);
+    pStatus->controlT     = sReplies.at(1).toDouble(&bOk[1]);
+    pStatus->bRamping     = (sReplies.at(2).toInt(&bOk[2]) == 1);
+    pStatus->heaterRange  = sReplies.at(3).toInt(&bOk[3]);
+    pStatus->heaterOutput = sReplies.at(4).toDouble(&bOk[4]);
+    return bOk[0] && bOk[1] && bOk[2] && bOk[3] && bOk[4];
+}
+
+
+// Runs in the GUI thread: if the sampler is on the bus
+// the status byte is polled at the next tick
 void
 LakeShore330::checkNotify() {
-    ibrsp(gpibId, &spollByte);
-    if(isGpibError(QString(Q_FUNC_INFO) + "Unable to query Ramp Status"))
+    if(!busMutex.tryLock())
         return;
-    if(!(spollByte & 64))
-        return;// SRQ not enabled
-    onGpibCallback(gpibId, ulong(ThreadIbsta()), ulong(ThreadIberr()), ThreadIbcnt());
+    ibrsp(gpibId, &spollByte);
+    if(!isGpibError(QString(Q_FUNC_INFO) + "Unable to query Ramp Status") &&
+       (spollByte & 64))// SRQ enabled
+        onGpibCallback(gpibId, ulong(ThreadIbsta()), ulong(ThreadIberr()), ThreadIbcnt());
+    busMutex.unlock();
 }
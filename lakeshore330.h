@@ -21,6 +21,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <QtGlobal>
 #include <QObject>
 #include <QTimer>
+#include <QMutex>
+#include <QStringList>
 #include "gpibdevice.h"
 
 
@@ -28,6 +30,16 @@ class LakeShore330 : public GpibDevice
 {
     Q_OBJECT
 
+public:
+    // What is needed at each monitoring tick
+    struct Status {
+        double sampleT;     // [K]
+        double controlT;    // [K]
+        bool   bRamping;
+        int    heaterRange; // 0=off 1=low 2=medium 3=high
+        double heaterOutput;// [%]
+    };
+
 public:
     explicit LakeShore330(int gpio, int address, QObject *parent=Q_NULLPTR);
     virtual ~LakeShore330();
@@ -36,18 +48,29 @@ public:
     double   getTemperature();
     bool     setTemperature(double Temperature);
     bool     switchPowerOn(int iRange);
+    bool     trySetTemperature(double Temperature);
+    bool     trySwitchPowerOn(int iRange);
     bool     switchPowerOff();
     bool     startRamp(double targetT, double rate);
     bool     stopRamp();
     bool     isRamping();
+    QStringList query(QStringList sQueries);
+    bool     getStatus(Status* pStatus);
+    bool     setSampleDataSRQ(bool bEnable);
+    bool     setZone(int iZone, double dTopT, int iRange, double dP, double dI, double dD);
 
 signals:
+    void     sampleDataReady();
 
 public slots:
     void checkNotify();
 
 protected:
     QTimer pollTimer;
+    // Serializes the bus transactions of the GUI and of the
+    // temperature sampler thread (they share the I/O buffers).
+    // The periodic GUI calls only try to lock it
+    QMutex busMutex;
 
 private:
     // Status Byte Register
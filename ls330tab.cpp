@@ -18,6 +18,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 #include "ls330tab.h"
 #include "mainwindow.h"
+#include "temperatureprofile.h"
 
 #include <QLineEdit>
 #include <QLabel>
@@ -33,6 +34,11 @@ LS330Tab::LS330Tab(int iConfiguration, QWidget *parent)
     , temperatureMax(475.0)
     , TRateMin(0.1)
     , TRateMax(10.0)
+    , TSamplingMin(0.5)// In seconds
+    , TSamplingMax(60.0)// In seconds
+    , stepBoundMin(0.1)
+    , gridPointsMin(2)
+    , gridPointsMax(10000)
     , waitTimeMin(100)
     , waitTimeMax(65000)
     , reachingTMin(0)// In minutes
@@ -50,6 +56,19 @@ LS330Tab::LS330Tab(int iConfiguration, QWidget *parent)
     sErrorStyle += "}";
 
     ThermostatCheckBox.setText("Use Thermostat");
+    CubicCheckBox.setText("Cubic T Interpolation");
+    DetectStabilityCheckBox.setText("Detect T Stability");
+    BoostCheckBox.setText("Boost the Set Point");
+    UploadZonesCheckBox.setText("Upload the PID Zones");
+    SampleReadyCheckBox.setText("Read T on Sample Data Ready");
+    AdaptiveStepCheckBox.setText("Adaptive T Step");
+    GridCheckBox.setText("Readings on a T Grid");
+    InverseGridCheckBox.setText("Grid Uniform in 1000/T");
+    // Same order of TemperatureProfile::shape
+    ProfileCombo.addItem(QString("Instrument Ramp"));
+    ProfileCombo.addItem(QString("Linear in T"));
+    ProfileCombo.addItem(QString("Linear in 1000/T"));
+    ProfileCombo.addItem(QString("Logarithmic in T"));
     // Build the Tab layout
     QGridLayout* pLayout = new QGridLayout();
     pLayout->addWidget(&ThermostatCheckBox,                     0, 0, 1, 1);
@@ -90,6 +109,33 @@ LS330Tab::LS330Tab(int iConfiguration, QWidget *parent)
         pLayout->addWidget(&TStopEdit,       1, 2, 1, 1);
         pLayout->addWidget(&TRateEdit,       2, 2, 1, 1);
     }
+    // The Thermostat is read in background at this cadence
+    pLayout->addWidget(new QLabel("T Sampling Interval[s]"), 5, 0, 1, 2, Qt::AlignRight);
+    pLayout->addWidget(&TSamplingEdit,   5, 2, 1, 1);
+    pLayout->addWidget(&CubicCheckBox,   6, 0, 1, 2);
+    pLayout->addWidget(&SampleReadyCheckBox, 6, 2, 1, 1);
+    if(myConfiguration != MainWindow::iConfRvsTime) {
+        pLayout->addWidget(&DetectStabilityCheckBox, 7, 0, 1, 2);
+        pLayout->addWidget(&BoostCheckBox,           7, 2, 1, 1);
+    }
+    if(myConfiguration == MainWindow::iConfIvsV) {
+        pLayout->addWidget(&AdaptiveStepCheckBox,    8, 0, 1, 1);
+        pLayout->addWidget(new QLabel("Min T Step[K]"), 8, 1, 1, 1, Qt::AlignRight);
+        pLayout->addWidget(&MinTStepEdit,            8, 2, 1, 1);
+        pLayout->addWidget(new QLabel("Max T Step[K]"), 9, 1, 1, 1, Qt::AlignRight);
+        pLayout->addWidget(&MaxTStepEdit,            9, 2, 1, 1);
+    }
+    else if(myConfiguration == MainWindow::iConfRvsT) {
+        pLayout->addWidget(&GridCheckBox,            8, 0, 1, 1);
+        pLayout->addWidget(new QLabel("Grid Points"), 8, 1, 1, 1, Qt::AlignRight);
+        pLayout->addWidget(&GridPointsEdit,          8, 2, 1, 1);
+        pLayout->addWidget(&InverseGridCheckBox,     9, 0, 1, 2);
+        pLayout->addWidget(new QLabel("T Profile"),  10, 1, 1, 1, Qt::AlignRight);
+        pLayout->addWidget(&ProfileCombo,            10, 2, 1, 1);
+        pLayout->addWidget(new QLabel("Dwell at T Stop[min]"), 11, 0, 1, 2, Qt::AlignRight);
+        pLayout->addWidget(&FinalDwellEdit,          11, 2, 1, 1);
+    }
+    pLayout->addWidget(&UploadZonesCheckBox,         12, 0, 1, 2);
 
     setLayout(pLayout);
 
@@ -107,9 +153,23 @@ LS330Tab::restoreSettings() {
     dTStop         = settings.value("LS330TabTStop", dTStart).toDouble();
     dTRate         = settings.value("LS330TabTRate", 1.0).toDouble();
     dTStep         = settings.value("LS330TabTStep", 1.0).toDouble();
+    dTSampling     = settings.value("LS330TabTSampling", 2.0).toDouble();
     iReachingTStart= settings.value("LS330TabReachingTStart", 0).toInt();
     iTimeToSteadyT = settings.value("LS330TabSteadyT", 0).toInt();
     bUseThermostat = settings.value("LS330TabUseThermostat", false).toBool();
+    bCubicT        = settings.value("LS330TabCubicT", false).toBool();
+    bDetectTStability = settings.value("LS330TabDetectTStability", false).toBool();
+    bTOnSampleReady   = settings.value("LS330TabTOnSampleReady", false).toBool();
+    bBoostSetPoint    = settings.value("LS330TabBoostSetPoint", false).toBool();
+    bUploadPidZones   = settings.value("LS330TabUploadPidZones", false).toBool();
+    bAdaptiveTStep    = settings.value("LS330TabAdaptiveTStep", false).toBool();
+    dMinTStep         = settings.value("LS330TabMinTStep", 0.5).toDouble();
+    dMaxTStep         = settings.value("LS330TabMaxTStep", 10.0).toDouble();
+    bTGrid            = settings.value("LS330TabTGrid", false).toBool();
+    bInverseTGrid     = settings.value("LS330TabInverseTGrid", false).toBool();
+    iGridPoints       = settings.value("LS330TabGridPoints", 100).toInt();
+    iTProfile         = settings.value("LS330TabTProfile", TemperatureProfile::InstrumentRamp).toInt();
+    iFinalDwell       = settings.value("LS330TabFinalDwell", 0).toInt();
 }
 
 
@@ -120,9 +180,23 @@ LS330Tab::saveSettings() {
     settings.setValue("LS330TabTStop", dTStop);
     settings.setValue("LS330TabTRate", dTRate);
     settings.setValue("LS330TabTStep", dTStep);
+    settings.setValue("LS330TabTSampling", dTSampling);
     settings.setValue("LS330TabReachingTStart", iReachingTStart);
     settings.setValue("LS330TabSteadyT", iTimeToSteadyT);
     settings.setValue("LS330TabUseThermostat", bUseThermostat);
+    settings.setValue("LS330TabCubicT", bCubicT);
+    settings.setValue("LS330TabDetectTStability", bDetectTStability);
+    settings.setValue("LS330TabTOnSampleReady", bTOnSampleReady);
+    settings.setValue("LS330TabBoostSetPoint", bBoostSetPoint);
+    settings.setValue("LS330TabUploadPidZones", bUploadPidZones);
+    settings.setValue("LS330TabAdaptiveTStep", bAdaptiveTStep);
+    settings.setValue("LS330TabMinTStep", dMinTStep);
+    settings.setValue("LS330TabMaxTStep", dMaxTStep);
+    settings.setValue("LS330TabTGrid", bTGrid);
+    settings.setValue("LS330TabInverseTGrid", bInverseTGrid);
+    settings.setValue("LS330TabGridPoints", iGridPoints);
+    settings.setValue("LS330TabTProfile", iTProfile);
+    settings.setValue("LS330TabFinalDwell", iFinalDwell);
 }
 
 
@@ -130,10 +204,24 @@ void
 LS330Tab::setToolTips() {
     QString sHeader = QString("Enter values in range [%1 : %2]");
     ThermostatCheckBox.setToolTip(QString("Enable/Disable Thermostat Use"));
+    CubicCheckBox.setToolTip(QString("Cubic (instead of Linear) Interpolation of T at the Reading Time"));
+    SampleReadyCheckBox.setToolTip(QString("Read T at each new Reading of the Sample Sensor (the Sampling Interval is the Maximum)"));
+    UploadZonesCheckBox.setToolTip(QString("Upload the P, I, D and Heater Range Zones derived from the previous Set Point Moves"));
+    BoostCheckBox.setToolTip(QString("Overshoot the commanded Set Point to reach T faster (once the Thermal Model is known)"));
+    DetectStabilityCheckBox.setToolTip(QString("End the Thermal Stabilization as soon as T is Steady (the Stabilization Time is the Maximum)"));
     TStartEdit.setToolTip(sHeader.arg(temperatureMin).arg(temperatureMax));
     TStopEdit.setToolTip(sHeader.arg(temperatureMin).arg(temperatureMax));
     TRateEdit.setToolTip(sHeader.arg(TRateMin).arg(TRateMax));
     TStepEdit.setToolTip("Enter values greater than 1.0");
+    TSamplingEdit.setToolTip(sHeader.arg(TSamplingMin).arg(TSamplingMax));
+    AdaptiveStepCheckBox.setToolTip(QString("Smaller T Steps where the I-V curves change faster"));
+    MinTStepEdit.setToolTip(sHeader.arg(stepBoundMin).arg(temperatureMax));
+    MaxTStepEdit.setToolTip(sHeader.arg(stepBoundMin).arg(temperatureMax));
+    GridCheckBox.setToolTip(QString("Trigger the Readings when T meets the Grid Points (instead of at fixed Intervals)"));
+    InverseGridCheckBox.setToolTip(QString("Grid Points equally spaced in 1000/T (for Arrhenius Plots)"));
+    GridPointsEdit.setToolTip(sHeader.arg(gridPointsMin).arg(gridPointsMax));
+    ProfileCombo.setToolTip(QString("The Host streams the Set Points of the Profiles other than the Instrument Ramp (T Rate is the one at the lower T; the Dwell applies to them only)"));
+    FinalDwellEdit.setToolTip(sHeader.arg(reachingTMin).arg(reachingTMax));
     MaxTimeToTStartEdit.setToolTip(sHeader.arg(reachingTMin).arg(reachingTMax));
     TimeToSteadyTEdit.setToolTip(sHeader.arg(timeToSteadyTMin).arg(timeToSteadyTMax));
 }
@@ -155,13 +243,45 @@ LS330Tab::initUI() {
     if(!isTStepValid(dTStep))
         dTStep = 1.0;
     TStepEdit.setText(QString("%1").arg(dTStep, 0, 'f', 2));
+    if(!isTSamplingValid(dTSampling))
+        dTSampling = 2.0;
+    TSamplingEdit.setText(QString("%1").arg(dTSampling, 0, 'f', 1));
+    if(!isStepBoundValid(dMinTStep))
+        dMinTStep = 0.5;
+    MinTStepEdit.setText(QString("%1").arg(dMinTStep, 0, 'f', 2));
+    if(!isStepBoundValid(dMaxTStep))
+        dMaxTStep = 10.0;
+    MaxTStepEdit.setText(QString("%1").arg(dMaxTStep, 0, 'f', 2));
+    AdaptiveStepCheckBox.setChecked(bAdaptiveTStep);
+    if(!isGridPointsValid(iGridPoints))
+        iGridPoints = 100;
+    GridPointsEdit.setText(QString("%1").arg(iGridPoints));
+    GridCheckBox.setChecked(bTGrid);
+    InverseGridCheckBox.setChecked(bInverseTGrid);
+    GridPointsEdit.setEnabled(bTGrid);
+    InverseGridCheckBox.setEnabled(bTGrid);
+    if((iTProfile < TemperatureProfile::InstrumentRamp) ||
+       (iTProfile > TemperatureProfile::LogT))
+        iTProfile = TemperatureProfile::InstrumentRamp;
+    ProfileCombo.setCurrentIndex(iTProfile);
+    if(!isReachingTimeValid(iFinalDwell))
+        iFinalDwell = 0;
+    FinalDwellEdit.setText(QString("%1").arg(iFinalDwell));
 
     ThermostatCheckBox.setChecked(bUseThermostat);
+    CubicCheckBox.setChecked(bCubicT);
+    DetectStabilityCheckBox.setChecked(bDetectTStability);
+    BoostCheckBox.setChecked(bBoostSetPoint);
+    UploadZonesCheckBox.setChecked(bUploadPidZones);
+    SampleReadyCheckBox.setChecked(bTOnSampleReady);
     TStartEdit.setEnabled(bUseThermostat);
     TStopEdit.setEnabled(bUseThermostat);
     TStepEdit.setEnabled(bUseThermostat);
     MaxTimeToTStartEdit.setEnabled(bUseThermostat);
     TimeToSteadyTEdit.setEnabled(bUseThermostat);
+    AdaptiveStepCheckBox.setEnabled(bUseThermostat);
+    MinTStepEdit.setEnabled(bUseThermostat && bAdaptiveTStep);
+    MaxTStepEdit.setEnabled(bUseThermostat && bAdaptiveTStep);
 
     // Timing parameters
     if(!isReachingTimeValid(iReachingTStart))
@@ -183,12 +303,40 @@ LS330Tab::connectSignals() {
             this, SLOT(on_TRateEdit_textChanged(const QString)));
     connect(&TStepEdit, SIGNAL(textChanged(const QString)),
             this, SLOT(on_TStepEdit_textChanged(const QString)));
+    connect(&TSamplingEdit, SIGNAL(textChanged(const QString)),
+            this, SLOT(on_TSamplingEdit_textChanged(const QString)));
     connect(&MaxTimeToTStartEdit, SIGNAL(textChanged(const QString)),
             this, SLOT(on_MaxTimeToTStartEdit_textChanged(const QString)));
     connect(&TimeToSteadyTEdit, SIGNAL(textChanged(const QString)),
             this, SLOT(on_TimeToSteadyTEdit_textChanged(const QString)));
     connect(&ThermostatCheckBox, SIGNAL(stateChanged(int)),
             this, SLOT(on_ThermostatCheckBox_stateChanged(int)));
+    connect(&CubicCheckBox, SIGNAL(stateChanged(int)),
+            this, SLOT(on_CubicCheckBox_stateChanged(int)));
+    connect(&DetectStabilityCheckBox, SIGNAL(stateChanged(int)),
+            this, SLOT(on_DetectStabilityCheckBox_stateChanged(int)));
+    connect(&UploadZonesCheckBox, SIGNAL(stateChanged(int)),
+            this, SLOT(on_UploadZonesCheckBox_stateChanged(int)));
+    connect(&BoostCheckBox, SIGNAL(stateChanged(int)),
+            this, SLOT(on_BoostCheckBox_stateChanged(int)));
+    connect(&SampleReadyCheckBox, SIGNAL(stateChanged(int)),
+            this, SLOT(on_SampleReadyCheckBox_stateChanged(int)));
+    connect(&AdaptiveStepCheckBox, SIGNAL(stateChanged(int)),
+            this, SLOT(on_AdaptiveStepCheckBox_stateChanged(int)));
+    connect(&MinTStepEdit, SIGNAL(textChanged(const QString)),
+            this, SLOT(on_MinTStepEdit_textChanged(const QString)));
+    connect(&MaxTStepEdit, SIGNAL(textChanged(const QString)),
+            this, SLOT(on_MaxTStepEdit_textChanged(const QString)));
+    connect(&GridCheckBox, SIGNAL(stateChanged(int)),
+            this, SLOT(on_GridCheckBox_stateChanged(int)));
+    connect(&InverseGridCheckBox, SIGNAL(stateChanged(int)),
+            this, SLOT(on_InverseGridCheckBox_stateChanged(int)));
+    connect(&GridPointsEdit, SIGNAL(textChanged(const QString)),
+            this, SLOT(on_GridPointsEdit_textChanged(const QString)));
+    connect(&ProfileCombo, SIGNAL(currentIndexChanged(int)),
+            this, SLOT(onProfileCombo_currentIndexChanged(int)));
+    connect(&FinalDwellEdit, SIGNAL(textChanged(const QString)),
+            this, SLOT(on_FinalDwellEdit_textChanged(const QString)));
 }
 
 
@@ -205,6 +353,24 @@ LS330Tab::isTRateValid(double dTRate) {
 }
 
 
+bool
+LS330Tab::isTSamplingValid(double dTSampling) {
+    return (dTSampling >= TSamplingMin) && (dTSampling <= TSamplingMax);
+}
+
+
+bool
+LS330Tab::isStepBoundValid(double dStep) {
+    return (dStep >= stepBoundMin) && (dStep <= temperatureMax);
+}
+
+
+bool
+LS330Tab::isGridPointsValid(int nPoints) {
+    return (nPoints >= gridPointsMin) && (nPoints <= gridPointsMax);
+}
+
+
 bool
 LS330Tab::isTStepValid(double dTStep) {
     return (dTStep >= 1.0);
@@ -233,6 +399,115 @@ LS330Tab::on_ThermostatCheckBox_stateChanged(int arg1) {
     TStepEdit.setEnabled(bUseThermostat);
     MaxTimeToTStartEdit.setEnabled(bUseThermostat);
     TimeToSteadyTEdit.setEnabled(bUseThermostat);
+    AdaptiveStepCheckBox.setEnabled(bUseThermostat);
+    MinTStepEdit.setEnabled(bUseThermostat && bAdaptiveTStep);
+    MaxTStepEdit.setEnabled(bUseThermostat && bAdaptiveTStep);
+}
+
+
+void
+LS330Tab::on_CubicCheckBox_stateChanged(int arg1) {
+    bCubicT = arg1;
+}
+
+
+void
+LS330Tab::on_DetectStabilityCheckBox_stateChanged(int arg1) {
+    bDetectTStability = arg1;
+}
+
+
+void
+LS330Tab::on_BoostCheckBox_stateChanged(int arg1) {
+    bBoostSetPoint = arg1;
+}
+
+
+void
+LS330Tab::on_UploadZonesCheckBox_stateChanged(int arg1) {
+    bUploadPidZones = arg1;
+}
+
+
+void
+LS330Tab::on_SampleReadyCheckBox_stateChanged(int arg1) {
+    bTOnSampleReady = arg1;
+}
+
+
+void
+LS330Tab::on_AdaptiveStepCheckBox_stateChanged(int arg1) {
+    bAdaptiveTStep = arg1;
+    MinTStepEdit.setEnabled(bUseThermostat && bAdaptiveTStep);
+    MaxTStepEdit.setEnabled(bUseThermostat && bAdaptiveTStep);
+}
+
+
+void
+LS330Tab::on_MinTStepEdit_textChanged(const QString &arg1) {
+    if(isStepBoundValid(arg1.toDouble())) {
+        dMinTStep = arg1.toDouble();
+        MinTStepEdit.setStyleSheet(sNormalStyle);
+    }
+    else {
+        MinTStepEdit.setStyleSheet(sErrorStyle);
+    }
+}
+
+
+void
+LS330Tab::on_MaxTStepEdit_textChanged(const QString &arg1) {
+    if(isStepBoundValid(arg1.toDouble())) {
+        dMaxTStep = arg1.toDouble();
+        MaxTStepEdit.setStyleSheet(sNormalStyle);
+    }
+    else {
+        MaxTStepEdit.setStyleSheet(sErrorStyle);
+    }
+}
+
+
+void
+LS330Tab::on_GridCheckBox_stateChanged(int arg1) {
+    bTGrid = arg1;
+    GridPointsEdit.setEnabled(bTGrid);
+    InverseGridCheckBox.setEnabled(bTGrid);
+}
+
+
+void
+LS330Tab::on_InverseGridCheckBox_stateChanged(int arg1) {
+    bInverseTGrid = arg1;
+}
+
+
+void
+LS330Tab::on_GridPointsEdit_textChanged(const QString &arg1) {
+    if(isGridPointsValid(arg1.toInt())) {
+        iGridPoints = arg1.toInt();
+        GridPointsEdit.setStyleSheet(sNormalStyle);
+    }
+    else {
+        GridPointsEdit.setStyleSheet(sErrorStyle);
+    }
+}
+
+
+void
+LS330Tab::onProfileCombo_currentIndexChanged(int index) {
+    iTProfile = index;
+}
+
+
+void
+LS330Tab::on_FinalDwellEdit_textChanged(const QString &arg1) {
+    if(isReachingTimeValid(arg1.toInt())) {
+        iFinalDwell = arg1.toInt();
+        FinalDwellEdit.setStyleSheet(sNormalStyle);
+    }
+    else {
+        FinalDwellEdit.setStyleSheet(sErrorStyle);
+    }
 }
 
 
@@ -272,6 +547,18 @@ LS330Tab::on_TRateEdit_textChanged(const QString &arg1) {
 }
 
 
+void
+LS330Tab::on_TSamplingEdit_textChanged(const QString &arg1) {
+    if(isTSamplingValid(arg1.toDouble())){
+        dTSampling = arg1.toDouble();
+        TSamplingEdit.setStyleSheet(sNormalStyle);
+    }
+    else {
+        TSamplingEdit.setStyleSheet(sErrorStyle);
+    }
+}
+
+
 void
 LS330Tab::on_TStepEdit_textChanged(const QString &arg1) {
     if(isTStepValid(arg1.toDouble())){
@@ -22,6 +22,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <QWidget>
 #include <QLineEdit>
 #include <QCheckBox>
+#include <QComboBox>
 #include <QLabel>
 
 
@@ -39,20 +40,48 @@ public:
     double dTStop;
     double dTStep;
     double dTRate;
+    double dTSampling;
+    double dMinTStep;
+    double dMaxTStep;
     int    iReachingTStart;
     int    iTimeToSteadyT;
+    int    iGridPoints;
+    int    iTProfile;
+    int    iFinalDwell;
     bool   bUseThermostat;
+    bool   bCubicT;
+    bool   bDetectTStability;
+    bool   bTOnSampleReady;
+    bool   bAdaptiveTStep;
+    bool   bTGrid;
+    bool   bInverseTGrid;
+    bool   bBoostSetPoint;
+    bool   bUploadPidZones;
 
 signals:
 
 public slots:
     void on_ThermostatCheckBox_stateChanged(int arg1);
+    void on_CubicCheckBox_stateChanged(int arg1);
+    void on_DetectStabilityCheckBox_stateChanged(int arg1);
+    void on_BoostCheckBox_stateChanged(int arg1);
+    void on_UploadZonesCheckBox_stateChanged(int arg1);
+    void on_SampleReadyCheckBox_stateChanged(int arg1);
+    void on_AdaptiveStepCheckBox_stateChanged(int arg1);
+    void on_MinTStepEdit_textChanged(const QString &arg1);
+    void on_MaxTStepEdit_textChanged(const QString &arg1);
+    void on_GridCheckBox_stateChanged(int arg1);
+    void on_InverseGridCheckBox_stateChanged(int arg1);
+    void on_GridPointsEdit_textChanged(const QString &arg1);
+    void onProfileCombo_currentIndexChanged(int index);
+    void on_FinalDwellEdit_textChanged(const QString &arg1);
     void on_TStartEdit_textChanged(const QString &arg1);
     void on_TStopEdit_textChanged(const QString &arg1);
     void on_TStepEdit_textChanged(const QString &arg1);
     void on_MaxTimeToTStartEdit_textChanged(const QString &arg1);
     void on_TimeToSteadyTEdit_textChanged(const QString &arg1);
     void on_TRateEdit_textChanged(const QString &arg1);
+    void on_TSamplingEdit_textChanged(const QString &arg1);
 
 protected:
     void initUI();
@@ -62,6 +91,9 @@ protected:
     bool isReachingTimeValid(int iReachingTime);
     bool isTimeToSteadyTValid(int iTime);
     bool isTRateValid(double dTRate);
+    bool isTSamplingValid(double dTSampling);
+    bool isStepBoundValid(double dStep);
+    bool isGridPointsValid(int nPoints);
 
 private:
     // QLineEdit styles
@@ -74,13 +106,33 @@ private:
     QLineEdit TRateEdit;
     QLineEdit MaxTimeToTStartEdit;
     QLineEdit TimeToSteadyTEdit;
+    QLineEdit TSamplingEdit;
+    QLineEdit MinTStepEdit;
+    QLineEdit MaxTStepEdit;
+    QLineEdit GridPointsEdit;
+    QLineEdit FinalDwellEdit;
 
     QCheckBox ThermostatCheckBox;
+    QCheckBox CubicCheckBox;
+    QCheckBox DetectStabilityCheckBox;
+    QCheckBox BoostCheckBox;
+    QCheckBox UploadZonesCheckBox;
+    QCheckBox SampleReadyCheckBox;
+    QCheckBox AdaptiveStepCheckBox;
+    QCheckBox GridCheckBox;
+    QCheckBox InverseGridCheckBox;
+
+    QComboBox ProfileCombo;
 
     const double temperatureMin;
     const double temperatureMax;
     const double TRateMin;
     const double TRateMax;
+    const double TSamplingMin;
+    const double TSamplingMax;
+    const double stepBoundMin;
+    const int    gridPointsMin;
+    const int    gridPointsMax;
     const int    waitTimeMin;
     const int    waitTimeMax;
     const int    reachingTMin;
@@ -26,6 +26,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "cs130tab.h"
 #include "filetab.h"
 #include "lakeshore330.h"
+#include "temperaturesampler.h"
 #include "cornerstone130.h"
 #include "plot2d.h"
 #include "EasterDlg.h"
@@ -54,6 +55,7 @@ MainWindow::MainWindow(int iBoard, QWidget *parent)
     , pLogFile(Q_NULLPTR)
     , pKeithley(Q_NULLPTR)
     , pLakeShore(Q_NULLPTR)
+    , pTSampler(Q_NULLPTR)
     , pCornerStone130(Q_NULLPTR)
     , pPlotMeasurements(Q_NULLPTR)
     , pPlotTemperature(Q_NULLPTR)
@@ -75,8 +77,30 @@ MainWindow::MainWindow(int iBoard, QWidget *parent)
     presentMeasure        = NoMeasure;
     bRunning              = false;
     isK236ReadyForTrigger = false;
+    junctionDirection     = 0;
+    bAverageSweeps        = false;
+    iSweepChunk           = 0;
+    sweepChunkTime        = 30.0;// Partial sweep results every 30s
+    dRowMeasure           = 0.0;
+    iPreScanConfiguration = 0;
+    iSettlingStep         = 0;
+    bCheckingStability    = false;
+    bCheckingTStability   = false;
+    bTGridActive          = false;
+    gridLatency           = 0.0;
+    bHostProfile          = false;
+    pMoveModel            = Q_NULLPTR;
+    moveSetPoint          = 0.0;
+    moveStartT            = 0.0;
+    bRecordingZone        = false;
+    bZonesUploaded        = false;
+    iHeaterRange          = 0;
+    loadPidZones();
+    loadThermalModel(&heatingModel, QString("Heating"));
+    loadThermalModel(&coolingModel, QString("Cooling"));
     maxPlotPoints         = 3000;
     wlResolution          = 5;// To be changed
+    noiseWindow           = 10;// Readings used to adapt the K236 speed
     // Prepare message logging
     sLogFileName = QString("gpibLog.txt");
     sLogDir = QStandardPaths::writableLocation(QStandardPaths::HomeLocation);
@@ -104,6 +128,8 @@ MainWindow::MainWindow(int iBoard, QWidget *parent)
 
 MainWindow::~MainWindow() {
     if(pKeithley != Q_NULLPTR)         delete pKeithley;
+    // The sampler thread must stop before the Thermostat is deleted
+    if(pTSampler != Q_NULLPTR)         delete pTSampler;
     if(pLakeShore != Q_NULLPTR)        delete pLakeShore;
     if(pCornerStone130 != Q_NULLPTR)   delete pCornerStone130;
     if(pPlotMeasurements != Q_NULLPTR) delete pPlotMeasurements;
@@ -127,10 +153,16 @@ MainWindow::closeEvent(QCloseEvent *event) {
         stabilizingTimer.stop();
         readingTTimer.stop();
         measuringTimer.stop();
+        gridTimer.stop();
+        profileTimer.stop();
+        boostTimer.stop();
         waitingTStartTimer.disconnect();
         stabilizingTimer.disconnect();
         readingTTimer.disconnect();
         measuringTimer.disconnect();
+        gridTimer.disconnect();
+        profileTimer.disconnect();
+        boostTimer.disconnect();
         if(pOutputFile) {
             if(pOutputFile->isOpen())
                 pOutputFile->close();
@@ -139,6 +171,8 @@ MainWindow::closeEvent(QCloseEvent *event) {
         }
         if(pKeithley)
             pKeithley->endVvsT();
+        if(pTSampler)
+            pTSampler->stopSampling();
         if(pLakeShore) {
             if(pLakeShore->isRamping())
                 pLakeShore->stopRamp();
@@ -163,10 +197,23 @@ MainWindow::stopTimers() {
     stabilizingTimer.stop();
     readingTTimer.stop();
     measuringTimer.stop();
+    gridTimer.stop();
+    profileTimer.stop();
+    boostTimer.stop();
     waitingTStartTimer.disconnect();
     stabilizingTimer.disconnect();
     readingTTimer.disconnect();
     measuringTimer.disconnect();
+    gridTimer.disconnect();
+    profileTimer.disconnect();
+    boostTimer.disconnect();
+    bCheckingTStability = false;
+    bTGridActive = false;
+    bHostProfile = false;
+    pMoveModel = Q_NULLPTR;
+    bRecordingZone = false;
+    if(pTSampler)
+        pTSampler->stopSampling();
 }
 
 /*!
@@ -353,6 +400,9 @@ MainWindow::checkInstruments() {
                 pLakeShore = new LakeShore330(gpibBoardID, resultlist[i], this);
                 connect(pLakeShore, SIGNAL(sendMessage(QString)),
                         this, SLOT(onLogMessage(QString)));
+                pTSampler = new TemperatureSampler(pLakeShore);
+                connect(pTSampler, SIGNAL(newTemperature(QDateTime, double, double)),
+                        this, SLOT(onNewTemperature(QDateTime, double, double)));
             }
             break;
         }
@@ -536,14 +586,32 @@ MainWindow::on_startRvsTButton_clicked() {
         return;
     }
     isK236ReadyForTrigger = false;
+    sPreScanResult.clear();
+    if(pConfigureDialog->pTabK236->bPreScan) {
+        iPreScanConfiguration = iConfRvsT;
+        if(startPreScan())
+            return;
+    }
+    startRvsT();
+}
+
+
+// Continues the start of the measure, after
+// the optional pre-scan of the sample
+void
+MainWindow::startRvsT() {
     connect(pKeithley, SIGNAL(complianceEvent()),
             this, SLOT(onComplianceEvent()));
     connect(pKeithley, SIGNAL(clearCompliance()),
             this, SLOT(onClearComplianceEvent()));
     connect(pKeithley, SIGNAL(readyForTrigger()),
             this, SLOT(onKeithleyReadyForTrigger()));
-    connect(pKeithley, SIGNAL(newReading(QDateTime, QString)),
-            this, SLOT(onNewRvsTKeithleyReading(QDateTime, QString)));
+    if(pConfigureDialog->pTabK236->bDelta)
+        connect(pKeithley, SIGNAL(newDeltaReading(QDateTime, double, double, double)),
+                this, SLOT(onNewRvsTDeltaReading(QDateTime, double, double, double)));
+    else
+        connect(pKeithley, SIGNAL(newReading(QDateTime, QString)),
+                this, SLOT(onNewRvsTKeithleyReading(QDateTime, QString)));
     // Initializing LakeShore 330
     ui->statusBar->showMessage("Initializing LakeShore 330...");
     if(pLakeShore->init()) {
@@ -552,6 +620,7 @@ MainWindow::on_startRvsTButton_clicked() {
         QApplication::restoreOverrideCursor();
         return;
     }
+    startTemperatureSampler();
     // Open the Output file
     ui->statusBar->showMessage("Opening Output file...");
     if(!prepareOutputFile(pConfigureDialog->pTabFile->sBaseDir,
@@ -566,19 +635,24 @@ MainWindow::on_startRvsTButton_clicked() {
     // Init the Plots
     initRvsTPlots();
     // Configure Thermostat
-    pLakeShore->setTemperature(pConfigureDialog->pTabLS330->dTStart);
-    pLakeShore->switchPowerOn(3);
+    moveToSetPoint(pConfigureDialog->pTabLS330->dTStart);
     // Configure Source-Measure Unit
     double dCompliance = pConfigureDialog->pTabK236->dCompliance;
+    pKeithley->setSpeedProfile(pConfigureDialog->pTabK236->iSpeedProfile);
+    pKeithley->setDeltaMode(pConfigureDialog->pTabK236->bDelta);
+    excitation.setup(0.0, qMax(pConfigureDialog->pTabK236->dMaxBias,
+                               qAbs(pConfigureDialog->pTabK236->dStart)));
+    dRowMeasure = 0.0;
+    measureNoise.reset(noiseWindow);
     if(pConfigureDialog->pTabK236->bSourceI) {
         presentMeasure = RvsTSourceI;
         double dAppliedCurrent = pConfigureDialog->pTabK236->dStart;
-        pKeithley->initVvsTSourceI(dAppliedCurrent, dCompliance);
+        pKeithley->initVvsTSourceI(dAppliedCurrent, dCompliance, false);
     }
     else {
         presentMeasure = RvsTSourceV;
         double dAppliedVoltage = pConfigureDialog->pTabK236->dStart;
-        pKeithley->initVvsTSourceV(dAppliedVoltage, dCompliance);
+        pKeithley->initVvsTSourceV(dAppliedVoltage, dCompliance, false);
     }
     // Configure the needed timers
     connect(&waitingTStartTimer, SIGNAL(timeout()),
@@ -592,11 +666,9 @@ MainWindow::on_startRvsTButton_clicked() {
     readingTTimer.start(30000);
     // All done... compute the time needed for the measurement:
     startMeasuringTime = QDateTime::currentDateTime();
-    double deltaT, expectedMinutes;
-    deltaT = pConfigureDialog->pTabLS330->dTStop -
-             pConfigureDialog->pTabLS330->dTStart;
-    expectedMinutes = deltaT / pConfigureDialog->pTabLS330->dTRate +
-                      pConfigureDialog->pTabLS330->iReachingTStart +
+    double expectedMinutes;
+    expectedMinutes = rampMinutes() +
+                      reachingMinutes(currentTemperature, pConfigureDialog->pTabLS330->dTStart) +
                       pConfigureDialog->pTabLS330->iTimeToSteadyT;
     endMeasureTime = startMeasuringTime.addSecs(qint64(expectedMinutes*60.0));
     QString sString = endMeasureTime.toString("hh:mm dd-MM-yyyy");
@@ -612,6 +684,7 @@ MainWindow::on_startRvsTButton_clicked() {
                                .arg(pConfigureDialog->pTabLS330->dTStart));
     // Start the reaching of the Initial Temperature
     waitingTStartTimer.start(5000);
+    startThermalStabilityCheck(pConfigureDialog->pTabLS330->dTStart);
 }
 
 
@@ -620,14 +693,34 @@ MainWindow::writeRvsTHeader() {
     // Write the header
     // To cope with the GnuPlot way to handle the comment lines
     // we need a # as a first chraracter in each row.
-    pOutputFile->write(QString("#%1 %2 %3 %4 %5 %6")
-                       .arg("T-Dark[K]", 12)
-                       .arg("V-Dark[V]", 12)
-                       .arg("I-Dark[A]", 12)
-                       .arg("T-Photo[K]", 12)
-                       .arg("V-Photo[V]", 12)
-                       .arg("I-Photo[A]\n", 12)
-                       .toLocal8Bit());
+    if(pConfigureDialog->pTabK236->bDelta) {
+        // The offset is in the units of the measured quantity
+        QString sOffset = pConfigureDialog->pTabK236->bSourceI ? "[V]" : "[A]";
+        pOutputFile->write(QString("#%1 %2 %3 %4 %5 %6 %7 %8 %9 %10\n")
+                           .arg("T-Dark[K]", 12)
+                           .arg("V-Dark[V]", 12)
+                           .arg("I-Dark[A]", 12)
+                           .arg("Off-Dark"+sOffset, 12)
+                           .arg("dT-Dark[K]", 12)
+                           .arg("T-Photo[K]", 12)
+                           .arg("V-Photo[V]", 12)
+                           .arg("I-Photo[A]", 12)
+                           .arg("Off-Photo"+sOffset, 12)
+                           .arg("dT-Photo[K]", 12)
+                           .toLocal8Bit());
+    }
+    else {
+        pOutputFile->write(QString("#%1 %2 %3 %4 %5 %6 %7 %8\n")
+                           .arg("T-Dark[K]", 12)
+                           .arg("V-Dark[V]", 12)
+                           .arg("I-Dark[A]", 12)
+                           .arg("dT-Dark[K]", 12)
+                           .arg("T-Photo[K]", 12)
+                           .arg("V-Photo[V]", 12)
+                           .arg("I-Photo[A]", 12)
+                           .arg("dT-Photo[K]", 12)
+                           .toLocal8Bit());
+    }
     QStringList HeaderLines = pConfigureDialog->pTabFile->sSampleInfo.split("\n");
     for(int i=0; i<HeaderLines.count(); i++) {
         pOutputFile->write("# ");
@@ -649,6 +742,14 @@ MainWindow::writeRvsTHeader() {
                            .arg(pConfigureDialog->pTabK236->dStart)
                            .arg(pConfigureDialog->pTabK236->dCompliance).toLocal8Bit());
     }
+    if(pConfigureDialog->pTabK236->bDelta)
+        pOutputFile->write(QString("# Acquisition=Delta (Bias Reversal)\n").toLocal8Bit());
+    if(pConfigureDialog->pTabK236->bTrackExcitation)
+        pOutputFile->write(QString("# Excitation=Tracking Max_Bias=%1\n")
+                           .arg(qMax(pConfigureDialog->pTabK236->dMaxBias,
+                                     qAbs(pConfigureDialog->pTabK236->dStart))).toLocal8Bit());
+    writeSpeedProfileHeader();
+    writePreScanHeader();
     pOutputFile->write(QString("# T_Start=%1[K] T_Stop=%2[K] T_Rate=%3[K/min]\n")
                        .arg(pConfigureDialog->pTabLS330->dTStart)
                        .arg(pConfigureDialog->pTabLS330->dTStop)
@@ -656,6 +757,16 @@ MainWindow::writeRvsTHeader() {
     pOutputFile->write(QString("# Max_T_Start_Wait=%1[min] T_Stabilize_Time=%2[min]\n")
                        .arg(pConfigureDialog->pTabLS330->iReachingTStart)
                        .arg(pConfigureDialog->pTabLS330->iTimeToSteadyT).toLocal8Bit());
+    if(pConfigureDialog->pTabLS330->bTGrid &&
+       !pConfigureDialog->pTabK236->bDelta)
+        pOutputFile->write(QString("# Acquisition=T_Grid Points=%1 Spacing=%2\n")
+                           .arg(pConfigureDialog->pTabLS330->iGridPoints)
+                           .arg(pConfigureDialog->pTabLS330->bInverseTGrid ? "1000/T" : "T").toLocal8Bit());
+    writeTProfileHeader();
+    writeTStabilityHeader();
+    writeThermalModelHeader();
+    writeHeaterRangeHeader();
+    writeTInterpolationHeader();
     pOutputFile->flush();
 }
 
@@ -714,14 +825,32 @@ MainWindow::on_startRvsTimeButton_clicked() {
         return;
     }
     isK236ReadyForTrigger = false;
+    sPreScanResult.clear();
+    if(pConfigureDialog->pTabK236->bPreScan) {
+        iPreScanConfiguration = iConfRvsTime;
+        if(startPreScan())
+            return;
+    }
+    startRvsTime();
+}
+
+
+// Continues the start of the measure, after
+// the optional pre-scan of the sample
+void
+MainWindow::startRvsTime() {
     connect(pKeithley, SIGNAL(complianceEvent()),
             this, SLOT(onComplianceEvent()));
     connect(pKeithley, SIGNAL(clearCompliance()),
             this, SLOT(onClearComplianceEvent()));
     connect(pKeithley, SIGNAL(readyForTrigger()),
             this, SLOT(onKeithleyReadyForTrigger()));
-    connect(pKeithley, SIGNAL(newReading(QDateTime, QString)),
-            this, SLOT(onNewRvsTimeKeithleyReading(QDateTime, QString)));
+    if(pConfigureDialog->pTabK236->bDelta)
+        connect(pKeithley, SIGNAL(newDeltaReading(QDateTime, double, double, double)),
+                this, SLOT(onNewRvsTimeDeltaReading(QDateTime, double, double, double)));
+    else
+        connect(pKeithley, SIGNAL(newReading(QDateTime, QString)),
+                this, SLOT(onNewRvsTimeKeithleyReading(QDateTime, QString)));
     // Initializing LakeShore 330
     ui->statusBar->showMessage("Initializing LakeShore 330...");
     if(pLakeShore->init()) {
@@ -730,6 +859,7 @@ MainWindow::on_startRvsTimeButton_clicked() {
         QApplication::restoreOverrideCursor();
         return;
     }
+    startTemperatureSampler();
     // Open the Output file
     ui->statusBar->showMessage("Opening Output file...");
     if(!prepareOutputFile(pConfigureDialog->pTabFile->sBaseDir,
@@ -745,15 +875,44 @@ MainWindow::on_startRvsTimeButton_clicked() {
     initRvsTimePlots();
     // Configure Source-Measure Unit
     double dCompliance = pConfigureDialog->pTabK236->dCompliance;
-    if(pConfigureDialog->pTabK236->bSourceI) {
+    bool bContinuous = pConfigureDialog->pTabK236->bContinuous;
+    pKeithley->setSpeedProfile(pConfigureDialog->pTabK236->iSpeedProfile);
+    pKeithley->setDeltaMode(pConfigureDialog->pTabK236->bDelta);
+    excitation.setup(0.0, qMax(pConfigureDialog->pTabK236->dMaxBias,
+                               qAbs(pConfigureDialog->pTabK236->dStart)));
+    dRowMeasure = 0.0;
+    measureNoise.reset(noiseWindow);
+    if(pConfigureDialog->pTabK236->bBurst) {
+        int nPoints = pConfigureDialog->pTabK236->iBurstPoints;
+        double dDelayms = double(pConfigureDialog->pTabK236->iBurstDelay);
+        disconnect(pKeithley, SIGNAL(readyForTrigger()),
+                   this, SLOT(onKeithleyReadyForTrigger()));
+        disconnect(pKeithley, SIGNAL(newReading(QDateTime, QString)),
+                   this, SLOT(onNewRvsTimeKeithleyReading(QDateTime, QString)));
+        connect(pKeithley, SIGNAL(readyForTrigger()),
+                this, SLOT(onKeithleyReadyForSweepTrigger()));
+        connect(pKeithley, SIGNAL(sweepDone(QDateTime,QString)),
+                this, SLOT(onRvsTimeBurstDone(QDateTime,QString)));
+        if(pConfigureDialog->pTabK236->bSourceI) {
+            presentMeasure = RvsTimeSourceI;
+            double dAppliedCurrent = pConfigureDialog->pTabK236->dStart;
+            pKeithley->initBurst(true, dAppliedCurrent, nPoints, dDelayms, dCompliance);
+        }
+        else {
+            presentMeasure = RvsTimeSourceV;
+            double dAppliedVoltage = pConfigureDialog->pTabK236->dStart;
+            pKeithley->initBurst(false, dAppliedVoltage, nPoints, dDelayms, dCompliance);
+        }
+    }
+    else if(pConfigureDialog->pTabK236->bSourceI) {
         presentMeasure = RvsTimeSourceI;
         double dAppliedCurrent = pConfigureDialog->pTabK236->dStart;
-        pKeithley->initVvsTSourceI(dAppliedCurrent, dCompliance);
+        pKeithley->initVvsTSourceI(dAppliedCurrent, dCompliance, bContinuous);
     }
     else {
         presentMeasure = RvsTimeSourceV;
         double dAppliedVoltage = pConfigureDialog->pTabK236->dStart;
-        pKeithley->initVvsTSourceV(dAppliedVoltage, dCompliance);
+        pKeithley->initVvsTSourceV(dAppliedVoltage, dCompliance, bContinuous);
     }
     // Configure the needed timers
     connect(&readingTTimer, SIGNAL(timeout()),
@@ -764,11 +923,14 @@ MainWindow::on_startRvsTimeButton_clicked() {
     readingTTimer.start(30000);
     if(pConfigureDialog->pTabLS330->bUseThermostat) {
         pLakeShore->setTemperature(pConfigureDialog->pTabLS330->dTStart);
-        pLakeShore->switchPowerOn(3);
+        bool bHeating = pConfigureDialog->pTabLS330->dTStop > pConfigureDialog->pTabLS330->dTStart;
+        setHeaterRange(heaterRangeFor(pConfigureDialog->pTabLS330->dTStart,
+                                      bHeating ? pConfigureDialog->pTabLS330->dTRate : 0.0));
         if(!pLakeShore->startRamp(pConfigureDialog->pTabLS330->dTStop, pConfigureDialog->pTabLS330->dTRate)) {
             ui->statusBar->showMessage(QString("Error Starting the Measure"));
             return;
         }
+        rampStartTime = QDateTime::currentDateTime();
     }
     ui->startRvsTButton->setDisabled(true);
     ui->startIvsVButton->setDisabled(true);
@@ -776,10 +938,16 @@ MainWindow::on_startRvsTimeButton_clicked() {
     ui->lambdaScanButton->setDisabled(true);
     ui->lampButton->setDisabled(true);
     bRunning = true;
-    double timeBetweenMeasurements = pConfigureDialog->pTabK236->dInterval*1000.0;
-    connect(&measuringTimer, SIGNAL(timeout()),
-            this, SLOT(onTimeToGetNewMeasure()));
-    measuringTimer.start(int(timeBetweenMeasurements));
+    // In Hardware Paced and Burst modes the readings arrive
+    // as soon as they are completed: no need to trigger them
+    if(!pConfigureDialog->pTabK236->bContinuous &&
+       !pConfigureDialog->pTabK236->bBurst)
+    {
+        double timeBetweenMeasurements = pConfigureDialog->pTabK236->dInterval*1000.0;
+        connect(&measuringTimer, SIGNAL(timeout()),
+                this, SLOT(onTimeToGetNewMeasure()));
+        measuringTimer.start(int(timeBetweenMeasurements));
+    }
     dateStart = QDateTime::currentDateTime();
     ui->statusBar->showMessage(QString("%1 Measure started")
                                .arg(dateStart.toString()));
@@ -791,12 +959,23 @@ MainWindow::writeRvsTimeHeader() {
     // Write the header
     // To cope with the GnuPlot way to handle the comment lines
     // we need a # as a first chraracter in each row.
-    pOutputFile->write(QString("#%1 %2 %3 %4\n")
-                       .arg("Time[s]", 12)
-                       .arg("V[V]", 12)
-                       .arg("I[A]", 12)
-                       .arg("T[K]", 12)
-                       .toLocal8Bit());
+    if(pConfigureDialog->pTabK236->bDelta)
+        pOutputFile->write(QString("#%1 %2 %3 %4 %5 %6\n")
+                           .arg("Time[s]", 12)
+                           .arg("V[V]", 12)
+                           .arg("I[A]", 12)
+                           .arg("T[K]", 12)
+                           .arg(pConfigureDialog->pTabK236->bSourceI ? "Offset[V]" : "Offset[A]", 12)
+                           .arg("dT[K]", 12)
+                           .toLocal8Bit());
+    else
+        pOutputFile->write(QString("#%1 %2 %3 %4 %5\n")
+                           .arg("Time[s]", 12)
+                           .arg("V[V]", 12)
+                           .arg("I[A]", 12)
+                           .arg("T[K]", 12)
+                           .arg("dT[K]", 12)
+                           .toLocal8Bit());
     QStringList HeaderLines = pConfigureDialog->pTabFile->sSampleInfo.split("\n");
     for(int i=0; i<HeaderLines.count(); i++) {
         pOutputFile->write("# ");
@@ -813,6 +992,23 @@ MainWindow::writeRvsTimeHeader() {
                            .arg(pConfigureDialog->pTabK236->dStart)
                            .arg(pConfigureDialog->pTabK236->dCompliance).toLocal8Bit());
     }
+    if(pConfigureDialog->pTabK236->bContinuous)
+        pOutputFile->write(QString("# Acquisition=Hardware Paced\n").toLocal8Bit());
+    if(pConfigureDialog->pTabK236->bDelta)
+        pOutputFile->write(QString("# Acquisition=Delta (Bias Reversal)\n").toLocal8Bit());
+    if(pConfigureDialog->pTabK236->bTrackExcitation)
+        pOutputFile->write(QString("# Excitation=Tracking Max_Bias=%1\n")
+                           .arg(qMax(pConfigureDialog->pTabK236->dMaxBias,
+                                     qAbs(pConfigureDialog->pTabK236->dStart))).toLocal8Bit());
+    writeSpeedProfileHeader();
+    writePreScanHeader();
+    if(pConfigureDialog->pTabK236->bBurst)
+        pOutputFile->write(QString("# Acquisition=Burst Points=%1 Delay=%2[ms]\n")
+                           .arg(pConfigureDialog->pTabK236->iBurstPoints)
+                           .arg(pConfigureDialog->pTabK236->iBurstDelay).toLocal8Bit());
+    if(pConfigureDialog->pTabLS330->bUseThermostat)
+        writeHeaterRangeHeader();
+    writeTInterpolationHeader();
     pOutputFile->flush();
 }
 
@@ -869,6 +1065,7 @@ MainWindow::on_startIvsVButton_clicked() {
         stopIvsV();
         return;
     }
+    startTemperatureSampler();
     // Open the Output file
     ui->statusBar->showMessage("Opening Output file...");
     if(!prepareOutputFile(pConfigureDialog->pTabFile->sBaseDir,
@@ -877,6 +1074,7 @@ MainWindow::on_startIvsVButton_clicked() {
         stopIvsV();
         return;
     }
+    bAverageSweeps = pConfigureDialog->pTabK236->iMaxRepeats > 1;
     // Write IvsV  File Header
     writeIvsVHeader();
     // Initi the Plots
@@ -892,7 +1090,12 @@ MainWindow::on_startIvsVButton_clicked() {
     double expectedSeconds;
     startMeasuringTime = QDateTime::currentDateTime();
     expectedSeconds = 0.32+pConfigureDialog->pTabK236->iWaitTime/1000.0;
+    if(pConfigureDialog->pTabK236->bPulsed)
+        expectedSeconds = (pConfigureDialog->pTabK236->iPulseOn +
+                           pConfigureDialog->pTabK236->iPulseOff)/1000.0;
     expectedSeconds *= pConfigureDialog->pTabK236->iNSweepPoints;
+    if(bAverageSweeps)// Worst case
+        expectedSeconds *= pConfigureDialog->pTabK236->iMaxRepeats;
     if(pConfigureDialog->pTabLS330->bUseThermostat) {
         connect(&waitingTStartTimer, SIGNAL(timeout()),
                 this, SLOT(onTimeToCheckT()));
@@ -900,9 +1103,13 @@ MainWindow::on_startIvsVButton_clicked() {
         // Start the reaching of the Initial Temperature
         // Configure Thermostat
         setPointT = pConfigureDialog->pTabLS330->dTStart;
-        pLakeShore->setTemperature(setPointT);
-        pLakeShore->switchPowerOn(3);
+        moveToSetPoint(setPointT);
         waitingTStartTimer.start(5000);
+        startThermalStabilityCheck(setPointT);
+        tStepScheduler.reset(pConfigureDialog->pTabLS330->dTStep,
+                             pConfigureDialog->pTabLS330->dMinTStep,
+                             pConfigureDialog->pTabLS330->dMaxTStep,
+                             tStepTargetChange);
         ui->statusBar->showMessage(QString("%1 Waiting Initial T[%2K]")
                                    .arg(waitingTStartTime.toString())
                                    .arg(pConfigureDialog->pTabLS330->dTStart));
@@ -910,7 +1117,9 @@ MainWindow::on_startIvsVButton_clicked() {
         double deltaT;
         deltaT = pConfigureDialog->pTabLS330->dTStop -
                  pConfigureDialog->pTabLS330->dTStart;
-        expectedSeconds += 60.0 *(pConfigureDialog->pTabLS330->iReachingTStart +
+        expectedSeconds += 60.0 *(reachingMinutes(pConfigureDialog->pTabLS330->dTStart,
+                                                  pConfigureDialog->pTabLS330->dTStart +
+                                                  pConfigureDialog->pTabLS330->dTStep) +
                                   pConfigureDialog->pTabLS330->iTimeToSteadyT);
         expectedSeconds *= int(deltaT / pConfigureDialog->pTabLS330->dTStep);
     }
@@ -931,10 +1140,20 @@ MainWindow::on_startIvsVButton_clicked() {
 void
 MainWindow::writeIvsVHeader() {
     // To cope with GnuPlot way to handle the comment lines
-    pOutputFile->write(QString("#%1 %2 %3\n")
-                       .arg("Voltage[V]", 12)
-                       .arg("Current[A]", 12)
-                       .arg("Temp.[K]", 12).toLocal8Bit());
+    if(bAverageSweeps) {
+        pOutputFile->write(QString("#%1 %2 %3 %4\n")
+                           .arg("Voltage[V]", 12)
+                           .arg("Current[A]", 12)
+                           .arg("Temp.[K]", 12)
+                           .arg(pConfigureDialog->pTabK236->bSourceI ? "Std.Err.[V]" : "Std.Err.[A]", 12)
+                           .toLocal8Bit());
+    }
+    else {
+        pOutputFile->write(QString("#%1 %2 %3\n")
+                           .arg("Voltage[V]", 12)
+                           .arg("Current[A]", 12)
+                           .arg("Temp.[K]", 12).toLocal8Bit());
+    }
     QStringList HeaderLines = pConfigureDialog->pTabFile->sSampleInfo.split("\n");
     for(int i=0; i<HeaderLines.count(); i++) {
         pOutputFile->write("# ");
@@ -953,14 +1172,41 @@ MainWindow::writeIvsVHeader() {
                            .arg(pConfigureDialog->pTabK236->dStop)
                            .arg(pConfigureDialog->pTabK236->dCompliance).toLocal8Bit());
     }
+    writeSpeedProfileHeader();
+    if(bAverageSweeps) {
+        pOutputFile->write(QString("# Max_Repeats=%1 Target_Error=%2[%]\n")
+                           .arg(pConfigureDialog->pTabK236->iMaxRepeats)
+                           .arg(pConfigureDialog->pTabK236->dTargetError).toLocal8Bit());
+    }
+    if(pConfigureDialog->pTabK236->bHysteresis)
+        pOutputFile->write(QString("# Sweep=Hysteresis Loop\n").toLocal8Bit());
+    if(pConfigureDialog->pTabK236->bPulsed)
+        pOutputFile->write(QString("# Pulsed Ton=%1[ms] Toff=%2[ms]\n")
+                           .arg(pConfigureDialog->pTabK236->iPulseOn)
+                           .arg(pConfigureDialog->pTabK236->iPulseOff).toLocal8Bit());
+    else if(pConfigureDialog->pTabK236->bAutoDelay)
+        pOutputFile->write(QString("# Delay=Auto Max_Delay=%1[ms]\n")
+                           .arg(pConfigureDialog->pTabK236->iWaitTime).toLocal8Bit());
+    if(pConfigureDialog->pTabLS330->bUseThermostat &&
+       pConfigureDialog->pTabK236->bStabilityCheck)
+        pOutputFile->write(QString("# Wait_Electrical_Stability Max_Drift=%1[%/min]\n")
+                           .arg(pConfigureDialog->pTabK236->dMaxDrift).toLocal8Bit());
     if(pConfigureDialog->pTabLS330->bUseThermostat) {
         pOutputFile->write(QString("# T_Start=%1[K] T_Stop=%2[K] T_Step=%3[K]\n")
                            .arg(pConfigureDialog->pTabLS330->dTStart)
                            .arg(pConfigureDialog->pTabLS330->dTStop)
                            .arg(pConfigureDialog->pTabLS330->dTStep).toLocal8Bit());
+        if(pConfigureDialog->pTabLS330->bAdaptiveTStep)
+            pOutputFile->write(QString("# T_Step=Adaptive Min=%1[K] Max=%2[K] Target_Change=%3[%]\n")
+                               .arg(pConfigureDialog->pTabLS330->dMinTStep)
+                               .arg(pConfigureDialog->pTabLS330->dMaxTStep)
+                               .arg(100.0*tStepTargetChange).toLocal8Bit());
         pOutputFile->write(QString("# Max_T_Start_Wait=%1[min] T_Stabilize_Time=%2[min]\n")
                            .arg(pConfigureDialog->pTabLS330->iReachingTStart)
                            .arg(pConfigureDialog->pTabLS330->iTimeToSteadyT).toLocal8Bit());
+        writeTStabilityHeader();
+        writeThermalModelHeader();
+        writeHeaterRangeHeader();
     }
     if(pConfigureDialog->pTabCS130->bPhoto) {
         pOutputFile->write(QString("# Lamp=On\n").toLocal8Bit());
@@ -1027,6 +1273,7 @@ MainWindow::on_lambdaScanButton_clicked() {
         QApplication::restoreOverrideCursor();
         return;
     }
+    startTemperatureSampler();
     // Open the Output file
     ui->statusBar->showMessage("Opening Output file...");
     if(!prepareOutputFile(pConfigureDialog->pTabFile->sBaseDir,
@@ -1042,20 +1289,20 @@ MainWindow::on_lambdaScanButton_clicked() {
     initSvsLPlots();
     // Configure Thermostat (if used)
     if(pConfigureDialog->pTabLS330->bUseThermostat) {
-        pLakeShore->setTemperature(pConfigureDialog->pTabLS330->dTStart);
-        pLakeShore->switchPowerOn(3);
+        moveToSetPoint(pConfigureDialog->pTabLS330->dTStart);
     }
     // Configure Source-Measure Unit
     double dCompliance = pConfigureDialog->pTabK236->dCompliance;
+    pKeithley->setSpeedProfile(pConfigureDialog->pTabK236->iSpeedProfile);
     if(pConfigureDialog->pTabK236->bSourceI) {
         presentMeasure = LambdaScanI;
         double dAppliedCurrent = pConfigureDialog->pTabK236->dStart;
-        pKeithley->initVvsTSourceI(dAppliedCurrent, dCompliance);
+        pKeithley->initVvsTSourceI(dAppliedCurrent, dCompliance, false);
     }
     else {
         presentMeasure = LambdaScanV;
         double dAppliedVoltage = pConfigureDialog->pTabK236->dStart;
-        pKeithley->initVvsTSourceV(dAppliedVoltage, dCompliance);
+        pKeithley->initVvsTSourceV(dAppliedVoltage, dCompliance, false);
     }
     // Configure the needed timers
     if(pConfigureDialog->pTabLS330->bUseThermostat) {
@@ -1076,7 +1323,7 @@ MainWindow::on_lambdaScanButton_clicked() {
                           wlResolution+0.5);
     double expectedSeconds = lambdaSteps * (pConfigureDialog->pTabK236->dInterval + 3.0);
     if(pConfigureDialog->pTabLS330->bUseThermostat)
-        expectedSeconds += 60.0*(pConfigureDialog->pTabLS330->iReachingTStart +
+        expectedSeconds += 60.0*(reachingMinutes(currentTemperature, pConfigureDialog->pTabLS330->dTStart) +
                                  pConfigureDialog->pTabLS330->iTimeToSteadyT);
     endMeasureTime = startMeasuringTime.addSecs(qint64(expectedSeconds));
     QString sString = endMeasureTime.toString("hh:mm dd-MM-yyyy");
@@ -1094,6 +1341,7 @@ MainWindow::on_lambdaScanButton_clicked() {
                                    .arg(pConfigureDialog->pTabLS330->dTStart));
         // Start the reaching of the Initial Temperature
         waitingTStartTimer.start(5000);
+        startThermalStabilityCheck(pConfigureDialog->pTabLS330->dTStart);
     }
     else {
         double timeBetweenMeasurements = pConfigureDialog->pTabK236->dInterval*1000.0;
@@ -1141,6 +1389,7 @@ MainWindow::writeLambdaScanHeader() {
                            .arg(pConfigureDialog->pTabK236->dStart)
                            .arg(pConfigureDialog->pTabK236->dCompliance).toLocal8Bit());
     }
+    writeSpeedProfileHeader();
     pOutputFile->write(QString("# T_Start=%1[K] T_Stop=%2[K] T_Step=%3[K/min]\n")
                        .arg(pConfigureDialog->pTabLS330->dTStart)
                        .arg(pConfigureDialog->pTabLS330->dTStop)
@@ -1148,6 +1397,9 @@ MainWindow::writeLambdaScanHeader() {
     pOutputFile->write(QString("# Max_T_Start_Wait=%1[min] T_Stabilize_Time=%2[min]\n")
                        .arg(pConfigureDialog->pTabLS330->iReachingTStart)
                        .arg(pConfigureDialog->pTabLS330->iTimeToSteadyT).toLocal8Bit());
+    writeTStabilityHeader();
+    writeThermalModelHeader();
+    writeHeaterRangeHeader();
     pOutputFile->flush();
 }
 
@@ -1161,24 +1413,186 @@ MainWindow::startI_Vscan(bool bSourceI) {
     double dStep = qAbs(dStop - dStart) / double(nSweepPoints);
     double dDelayms = double(pConfigureDialog->pTabK236->iWaitTime);
     double dCompliance = pConfigureDialog->pTabK236->dCompliance;
-    if(bSourceI) {// Source I Measure V
-        presentMeasure = IvsVSourceI;
-        connect(pKeithley, SIGNAL(sweepDone(QDateTime,QString)),
-                this, SLOT(onKeithleySweepDone(QDateTime,QString)));
-        pKeithley->initISweep(dStart, dStop, dStep, dDelayms, dCompliance);
+    pKeithley->setSpeedProfile(pConfigureDialog->pTabK236->iSpeedProfile);
+    if(bSourceI && pConfigureDialog->pTabK236->bJunctionCheck) {
+        // The sweep will start when the junction direction is known
+        double dJunctionBias = pConfigureDialog->pTabK236->dJunctionBias;
+        QVector<QPair<double, double>> biasPairs;
+        biasPairs.append(qMakePair(-0.5*dJunctionBias, 0.5*dJunctionBias));
+        biasPairs.append(qMakePair(-dJunctionBias, dJunctionBias));
+        junctionDirection = 0;
+        connect(pKeithley, SIGNAL(junctionCheckResult(double,double,double,double)),
+                this, SLOT(onJunctionCheckResult(double,double,double,double)));
+        connect(pKeithley, SIGNAL(junctionCheckDone(bool)),
+                this, SLOT(onJunctionCheckDone(bool)));
+        if(pKeithley->startJunctionCheck(biasPairs,
+                                         pConfigureDialog->pTabK236->dJunctionCompliance,
+                                         30000)) {
+            ui->statusBar->showMessage("Checking Junction...Please Wait");
+            return;
+        }
+        disconnect(pKeithley, SIGNAL(junctionCheckResult(double,double,double,double)),
+                   this, SLOT(onJunctionCheckResult(double,double,double,double)));
+        disconnect(pKeithley, SIGNAL(junctionCheckDone(bool)),
+                   this, SLOT(onJunctionCheckDone(bool)));
+        logMessage(QString(Q_FUNC_INFO) + QString(" Unable to start the Junction Check"));
+    }
+    sweepProgram.clear();
+    if(pConfigureDialog->pTabK236->bHysteresis)
+        sweepProgram.addHysteresis(bSourceI, dStart, dStop, dStep, dDelayms, dCompliance);
+    else
+        sweepProgram.addSegment(SweepSegment(bSourceI, dStart, dStop, dStep, dDelayms, dCompliance));
+    if(pConfigureDialog->pTabK236->bPulsed)
+        sweepProgram.setPulsed(pConfigureDialog->pTabK236->iPulseOn,
+                               pConfigureDialog->pTabK236->iPulseOff);
+    startSweepProgram();
+}
+
+
+void
+MainWindow::startSweepProgram() {
+    sweepVoltages.clear();
+    sweepCurrents.clear();
+    // The settling is measured again before each sweep
+    // since the sample changes with the temperature
+    if(pConfigureDialog->pTabK236->bAutoDelay &&
+       !pConfigureDialog->pTabK236->bPulsed)
+    {
+        if(startSettlingCheck())
+            return;
+        logMessage(QString(Q_FUNC_INFO) + QString(" Unable to Measure the Settling Times"));
     }
-    else {// Source V Measure I
-        presentMeasure = IvsVSourceV;
-        connect(pKeithley, SIGNAL(sweepDone(QDateTime,QString)),
-                this, SLOT(onKeithleySweepDone(QDateTime,QString)));
-        pKeithley->initVSweep(dStart, dStop, dStep, dDelayms, dCompliance);
+    runSweepProgram();
+}
+
+
+// Long sweeps are split in chunks lasting about sweepChunkTime
+// (and never exceeding the Keithley 236 Sweep Buffer) so that
+// the partial results are shown while the sweep is running
+void
+MainWindow::runSweepProgram() {
+    double dPointTime = double(pConfigureDialog->pTabK236->iWaitTime)/1000.0 +
+                        pKeithley->getReadingTime();
+    if(pConfigureDialog->pTabK236->bPulsed)
+        dPointTime = double(pConfigureDialog->pTabK236->iPulseOn +
+                            pConfigureDialog->pTabK236->iPulseOff)/1000.0;
+    int maxPoints = pKeithley->MAX_SWEEP_POINTS;
+    if(dPointTime > 0.0)
+        maxPoints = qBound(10, int(sweepChunkTime/dPointTime), pKeithley->MAX_SWEEP_POINTS);
+    sweepProgram.setMaxChunkPoints(maxPoints);
+    // The statistics will be sized on the first sweep
+    sweepStatistics.reset(0);
+    iSweepChunk = 0;
+    programSweepChunk();
+}
+
+
+// A burst without delay after a source step on each source range
+// used by the sweep program gives the settling transient of the
+// sample on that range
+bool
+MainWindow::startSettlingCheck() {
+    QVector<SweepSegment> segments;
+    for(int i=0; i<sweepProgram.chunks(); i++)
+        segments += sweepProgram.chunk(i);
+    settlingTable.reset(double(pConfigureDialog->pTabK236->iWaitTime));
+    settlingSteps = settlingTable.settlingSteps(segments);
+    if(settlingSteps.isEmpty())
+        return false;
+    iSettlingStep = 0;
+    connect(pKeithley, SIGNAL(sweepDone(QDateTime,QString)),
+            this, SLOT(onSettlingBurstDone(QDateTime,QString)),
+            Qt::UniqueConnection);
+    if(!programSettlingBurst()) {
+        disconnect(pKeithley, SIGNAL(sweepDone(QDateTime,QString)),
+                   this, SLOT(onSettlingBurstDone(QDateTime,QString)));
+        return false;
+    }
+    ui->statusBar->showMessage("Measuring the Settling Times...Please Wait");
+    return true;
+}
+
+
+bool
+MainWindow::programSettlingBurst() {
+    const SweepSegment& step = settlingSteps.at(iSettlingStep);
+    // Observe the transient for twice the configured Wait Time
+    double dDuration = 2.0*double(pConfigureDialog->pTabK236->iWaitTime)/1000.0;
+    int nPoints = qBound(20, int(dDuration/pKeithley->getBurstPeriod(0.0))+1,
+                         pKeithley->MAX_SWEEP_POINTS);
+    connect(pKeithley, SIGNAL(readyForTrigger()),
+            this, SLOT(onKeithleyReadyForSweepTrigger()),
+            Qt::UniqueConnection);
+    return pKeithley->initBurst(step.bSourceI, step.dStart, nPoints, 0.0, step.dCompliance);
+}
+
+
+void
+MainWindow::onSettlingBurstDone(QDateTime dataTime, QString sData) {
+    Q_UNUSED(dataTime)
+    const SweepSegment& step = settlingSteps.at(iSettlingStep);
+    QStringList sMeasures = QStringList(sData.split(",", QString::SkipEmptyParts));
+    QVector<double> measures;
+    for(int i=1; i<sMeasures.count(); i+=2)
+        measures.append(sMeasures.at(i).toDouble());
+    double dSettling = SettlingTable::settlingTime(measures,
+                                                   pKeithley->getBurstPeriod(),
+                                                   settlingTolerance);
+    int iRange = settlingTable.rangeOf(step.bSourceI, step.dStart);
+    // Never slower than the configured Wait Time
+    if(dSettling >= 0.0)
+        settlingTable.setDelay(step.bSourceI, iRange,
+                               qMin(qCeil(1000.0*dSettling), pConfigureDialog->pTabK236->iWaitTime));
+    else
+        logMessage(QString("No Settling Data for Source=%1").arg(step.dStart));
+    iSettlingStep++;
+    if(iSettlingStep < settlingSteps.count()) {
+        if(programSettlingBurst())
+            return;
+        logMessage(QString(Q_FUNC_INFO) + QString(" Unable to Continue the Settling Check"));
+    }
+    disconnect(pKeithley, SIGNAL(sweepDone(QDateTime,QString)),
+               this, SLOT(onSettlingBurstDone(QDateTime,QString)));
+    logMessage(QString("Settling Delays [ms]: %1").arg(settlingTable.toString()));
+    pOutputFile->write(QString("# Settling_Delays[ms] %1\n")
+                       .arg(settlingTable.toString()).toLocal8Bit());
+    sweepProgram.applySettling(settlingTable);
+    ui->statusBar->showMessage("Sweeping...Please Wait");
+    runSweepProgram();
+}
+
+
+// Programs the Keithley 236 with the present chunk of the
+// sweep program. The sweep will start on Ready for Trigger
+bool
+MainWindow::programSweepChunk() {
+    QVector<SweepSegment> segments = sweepProgram.chunk(iSweepChunk);
+    if(segments.isEmpty())
+        return false;
+    presentMeasure = segments.at(0).bSourceI ? IvsVSourceI : IvsVSourceV;
+    connect(pKeithley, SIGNAL(readyForTrigger()),
+            this, SLOT(onKeithleyReadyForSweepTrigger()),
+            Qt::UniqueConnection);
+    connect(pKeithley, SIGNAL(sweepDone(QDateTime,QString)),
+            this, SLOT(onKeithleySweepDone(QDateTime,QString)),
+            Qt::UniqueConnection);
+    if(!pKeithley->initSweepProgram(segments)) {
+        stopIvsV();
+        ui->statusBar->showMessage("Unable to Program the Sweep");
+        return false;
     }
+    // The following chunks do not wait for the next
+    // poll of the Keithley 236 status byte
+    if((iSweepChunk > 0) && pKeithley->isReadyForTrigger())
+        onKeithleyReadyForSweepTrigger();
+    return true;
 }
 
 
 void
 MainWindow::stopIvsV() {
     presentMeasure = NoMeasure;
+    bCheckingStability = false;
     if(pOutputFile) {
         pOutputFile->close();
         pOutputFile->deleteLater();
@@ -1187,6 +1601,7 @@ MainWindow::stopIvsV() {
     stopTimers();
     if(pKeithley != Q_NULLPTR) {
         pKeithley->disconnect();
+        pKeithley->abortJunctionCheck();
         pKeithley->stopSweep();
     }
     if(pLakeShore != Q_NULLPTR) {
@@ -1416,15 +1831,11 @@ MainWindow::initTemperaturePlot() {
 // ToDo: Change Name !!!
 void
 MainWindow::onTimeToCheckT() {
-    double T = pLakeShore->getTemperature();
+    double T = sampledTemperature();
     if(fabs(T-setPointT) < 0.15) {
         waitingTStartTimer.stop();
         waitingTStartTimer.disconnect();
-        connect(&stabilizingTimer, SIGNAL(timeout()),
-                this, SLOT(onSteadyTReached()));
-        stabilizingTimer.start(pConfigureDialog->pTabLS330->iTimeToSteadyT*60000);
-        ui->statusBar->showMessage(QString("Thermal Stabilization for %1 min.")
-                                   .arg(pConfigureDialog->pTabLS330->iTimeToSteadyT));
+        startThermalStabilization();
     }
     else {
         currentTime = QDateTime::currentDateTime();
@@ -1432,20 +1843,108 @@ MainWindow::onTimeToCheckT() {
         if(elapsedSec > qint64(pConfigureDialog->pTabLS330->iReachingTStart)*60) {
             waitingTStartTimer.stop();
             waitingTStartTimer.disconnect();
-            connect(&stabilizingTimer, SIGNAL(timeout()),
-                    this, SLOT(onSteadyTReached()));
-            stabilizingTimer.start(pConfigureDialog->pTabLS330->iTimeToSteadyT*60000);
-            ui->statusBar->showMessage(QString("Thermal Stabilization for %1 min.")
-                                       .arg(pConfigureDialog->pTabLS330->iTimeToSteadyT));
+            startThermalStabilization();
         }
     }
 }
 
 
+// The I-V sweep will start after the T Stabilize Time or,
+// when required, as soon as the sample is electrically stable
+void
+MainWindow::startThermalStabilization() {
+    connect(&stabilizingTimer, SIGNAL(timeout()),
+            this, SLOT(onSteadyTReached()));
+    stabilizingTimer.start(pConfigureDialog->pTabLS330->iTimeToSteadyT*60000);
+    ui->statusBar->showMessage(QString("Thermal Stabilization for %1 min.")
+                               .arg(pConfigureDialog->pTabLS330->iTimeToSteadyT));
+    if(pConfigureDialog->pTabK236->bStabilityCheck)
+        startStabilityCheck();
+}
+
+
+// Low bias readings of the sample resistance while
+// waiting for the thermal stabilization
+void
+MainWindow::startStabilityCheck() {
+    bool bSourceI = pConfigureDialog->pTabK236->bSourceI;
+    double dBias = stabilityBias*qMax(qAbs(pConfigureDialog->pTabK236->dStart),
+                                      qAbs(pConfigureDialog->pTabK236->dStop));
+    double dCompliance = pConfigureDialog->pTabK236->dCompliance;
+    // The sweep trigger will be connected again at the sweep start
+    disconnect(pKeithley, SIGNAL(readyForTrigger()),
+               this, SLOT(onKeithleyReadyForSweepTrigger()));
+    pKeithley->setSpeedProfile(pConfigureDialog->pTabK236->iSpeedProfile);
+    int iErr;
+    if(bSourceI)
+        iErr = pKeithley->initVvsTSourceI(dBias, dCompliance, false);
+    else
+        iErr = pKeithley->initVvsTSourceV(dBias, dCompliance, false);
+    if(iErr) {
+        logMessage(QString(Q_FUNC_INFO) + QString(" Unable to Start the Stability Check"));
+        return;
+    }
+    isK236ReadyForTrigger = false;
+    connect(pKeithley, SIGNAL(readyForTrigger()),
+            this, SLOT(onKeithleyReadyForTrigger()));
+    connect(pKeithley, SIGNAL(newReading(QDateTime, QString)),
+            this, SLOT(onStabilityReading(QDateTime, QString)));
+    stabilityDetector.reset(stabilityWindow, pConfigureDialog->pTabK236->dMaxDrift/100.0);
+    stabilityStartTime = QDateTime::currentDateTime();
+    connect(&measuringTimer, SIGNAL(timeout()),
+            this, SLOT(onTimeToGetNewMeasure()));
+    measuringTimer.start(stabilityInterval);
+    bCheckingStability = true;
+}
+
+
+void
+MainWindow::stopStabilityCheck() {
+    if(!bCheckingStability)
+        return;
+    bCheckingStability = false;
+    measuringTimer.stop();
+    measuringTimer.disconnect();
+    disconnect(pKeithley, SIGNAL(readyForTrigger()),
+               this, SLOT(onKeithleyReadyForTrigger()));
+    disconnect(pKeithley, SIGNAL(newReading(QDateTime, QString)),
+               this, SLOT(onStabilityReading(QDateTime, QString)));
+}
+
+
+void
+MainWindow::onStabilityReading(QDateTime dataTime, QString sDataRead) {
+    double current, voltage;
+    if(!bCheckingStability)
+        return;
+    if(!DecodeReadings(sDataRead, &current, &voltage))
+        return;
+    if(current == 0.0)
+        return;
+    double dElapsed = double(stabilityStartTime.msecsTo(dataTime))/1000.0;
+    stabilityDetector.addValue(dElapsed, voltage/current);
+    if(!stabilityDetector.isStable())
+        return;
+    logMessage(QString("Sample Stable after %1 s (Drift=%2 %/min)")
+               .arg(dElapsed)
+               .arg(100.0*stabilityDetector.relativeDrift()));
+    if(pOutputFile)
+        pOutputFile->write(QString("# T=%1[K] Stable after %2[s]\n")
+                           .arg(setPointT)
+                           .arg(dElapsed).toLocal8Bit());
+    stopStabilityCheck();
+    // Do not start the sweep from inside the Keithley callback
+    QTimer::singleShot(0, this, SLOT(onSteadyTReached()));
+}
+
+
 // Invoked when the thermal stabilization is done
 // during I-V measurements
 void
 MainWindow::onSteadyTReached() {
+    endSetPointMove();
+    stopStabilityCheck();
+    bCheckingTStability = false;
     stabilizingTimer.stop();
     stabilizingTimer.disconnect();
     // Update the time needed for the measurement:
@@ -1464,7 +1963,7 @@ MainWindow::onSteadyTReached() {
 // temperature Set Point
 void
 MainWindow::onTimeToCheckReachedT() {
-    double T = pLakeShore->getTemperature();
+    double T = sampledTemperature();
     if(fabs(T-pConfigureDialog->pTabLS330->dTStart) < 0.15) {
         waitingTStartTimer.disconnect();
         waitingTStartTimer.stop();
@@ -1475,14 +1974,12 @@ MainWindow::onTimeToCheckReachedT() {
                                    .arg(pConfigureDialog->pTabLS330->iTimeToSteadyT));
         // Compute the new time needed for the measurement:
         startMeasuringTime = QDateTime::currentDateTime();
-        double deltaT, expectedMinutes;
+        double expectedMinutes;
         expectedMinutes = pConfigureDialog->pTabLS330->iTimeToSteadyT;
         if((presentMeasure==RvsTSourceI)||
            (presentMeasure==RvsTSourceV))
         {
-            deltaT = pConfigureDialog->pTabLS330->dTStop -
-                     pConfigureDialog->pTabLS330->dTStart;
-            expectedMinutes += deltaT / pConfigureDialog->pTabLS330->dTRate;
+            expectedMinutes += rampMinutes();
         }
         endMeasureTime = startMeasuringTime.addSecs(qint64(expectedMinutes*60.0));
         QString sString = endMeasureTime.toString("hh:mm dd-MM-yyyy");
@@ -1506,7 +2003,9 @@ MainWindow::onTimeToCheckReachedT() {
 
 void
 MainWindow::onTimerStabilizeT() {
+    endSetPointMove();
     // It's time to start measurements
+    bCheckingTStability = false;
     stabilizingTimer.stop();
     stabilizingTimer.disconnect();
     pPlotTemperature->NewDataSet(2,//Id
@@ -1524,18 +2023,37 @@ MainWindow::onTimerStabilizeT() {
             this, SLOT(onTimeToGetNewMeasure()));
     if((presentMeasure==RvsTSourceI)||
         (presentMeasure==RvsTSourceV)) {
-        if(!pLakeShore->startRamp(pConfigureDialog->pTabLS330->dTStop, pConfigureDialog->pTabLS330->dTRate)) {
+        // Delta readings are not triggered one by one
+        bTGridActive = pConfigureDialog->pTabLS330->bTGrid &&
+                       !pConfigureDialog->pTabK236->bDelta;
+        if(pConfigureDialog->pTabLS330->bTGrid && !bTGridActive)
+            logMessage(QString("T Grid Disabled: Readings are not Software Triggered"));
+        if(bTGridActive) {
+            tGrid.setup(pConfigureDialog->pTabLS330->dTStart,
+                        pConfigureDialog->pTabLS330->dTStop,
+                        pConfigureDialog->pTabLS330->iGridPoints,
+                        pConfigureDialog->pTabLS330->bInverseTGrid);
+            gridLatency = 0.0;
+            gridTimer.setSingleShot(true);
+            connect(&gridTimer, SIGNAL(timeout()),
+                    this, SLOT(onTimeToTriggerOnGrid()));
+        }
+        bool bStarted;
+        if(pConfigureDialog->pTabLS330->iTProfile == TemperatureProfile::InstrumentRamp)
+            bStarted = pLakeShore->startRamp(pConfigureDialog->pTabLS330->dTStop, pConfigureDialog->pTabLS330->dTRate);
+        else
+            bStarted = startTemperatureProfile();
+        if(!bStarted) {
             ui->statusBar->showMessage(QString("Error Starting the Measure"));
             return;
         }
+        rampStartTime = QDateTime::currentDateTime();
     }
     double timeBetweenMeasurements = pConfigureDialog->pTabK236->dInterval*1000.0;
     measuringTimer.start(int(timeBetweenMeasurements));
     // Update the time needed for the measurement:
-    double deltaT, expectedMinutes;
-    deltaT = pConfigureDialog->pTabLS330->dTStop -
-             pConfigureDialog->pTabLS330->dTStart;
-    expectedMinutes = deltaT / pConfigureDialog->pTabLS330->dTRate;
+    double expectedMinutes;
+    expectedMinutes = rampMinutes();
     endMeasureTime = QDateTime::currentDateTime().addSecs(qint64(expectedMinutes*60.0));
     QString sString = endMeasureTime.toString("hh:mm dd-MM-yyyy");
     ui->endTimeEdit->setText(sString);
@@ -1546,11 +2064,13 @@ MainWindow::onTimerStabilizeT() {
 // ToDo: Change Name (onTimeToGetNewRamp ?)
 void
 MainWindow::onTimeToGetNewMeasure() {
-    getNewMeasure();
+    // On the T grid only the photo readings follow the timer
+    if(!bTGridActive || (currentLampStatus == LAMP_ON))
+        getNewMeasure();
     if((presentMeasure==RvsTSourceI) ||
        (presentMeasure==RvsTSourceV))
     {
-        if(!pLakeShore->isRamping()) {// Ramp is Done
+        if(!isThermostatRamping()) {// Ramp is Done
             stopRvsT();
             ui->statusBar->showMessage(QString("Measurements Completed !"));
             onClearComplianceEvent();
@@ -1562,7 +2082,7 @@ MainWindow::onTimeToGetNewMeasure() {
 
 void
 MainWindow::onTimeToReadT() {
-    currentTemperature = pLakeShore->getTemperature();
+    currentTemperature = sampledTemperature();
     currentTime = QDateTime::currentDateTime();
     ui->temperatureEdit->setText(QString("%1").arg(currentTemperature));
     pPlotTemperature->NewPoint(iCurrentTPlot,
@@ -1580,7 +2100,83 @@ void
 MainWindow::onComplianceEvent() {
     ui->labelCompliance->setText("Compliance");
     ui->labelCompliance->setStyleSheet(sErrorStyle);
-    logMessage("Compliance Event");
+    logMessage(QString("Compliance Event #%1").arg(pKeithley->getComplianceEvents()));
+    if(pConfigureDialog == Q_NULLPTR)
+        return;
+    // The compliance can be changed only in the dc measures
+    bool bDcMeasure = (presentMeasure == RvsTSourceI)    ||
+                      (presentMeasure == RvsTSourceV)    ||
+                      (presentMeasure == LambdaScanI)    ||
+                      (presentMeasure == LambdaScanV)    ||
+                      (((presentMeasure == RvsTimeSourceI) ||
+                        (presentMeasure == RvsTimeSourceV)) &&
+                       !pConfigureDialog->pTabK236->bBurst);
+    switch(pConfigureDialog->pTabK236->iCompliancePolicy) {
+    case Keithley236::ComplianceRaise:
+        // Do not reprogram the Keithley from inside its callback
+        if(bDcMeasure)
+            QTimer::singleShot(0, this, SLOT(onComplianceRaise()));
+        break;
+    case Keithley236::ComplianceAbort:
+        // Do not stop the measure from inside the Keithley callback
+        if(pKeithley->getComplianceEvents() >= pKeithley->MAX_COMPLIANCE_EVENTS)
+            QTimer::singleShot(0, this, SLOT(onComplianceAbort()));
+        break;
+    default:
+        break;
+    }
+}
+
+
+void
+MainWindow::onComplianceRaise() {
+    if(!bRunning)
+        return;
+    if(pKeithley->raiseCompliance(pConfigureDialog->pTabK236->dMaxCompliance)) {
+        logMessage(QString("Compliance Raised to %1").arg(pKeithley->getCompliance()));
+        onClearComplianceEvent();
+    }
+    else {
+        logMessage(QString("Unable to Raise the Compliance over %1").arg(pKeithley->getCompliance()));
+    }
+}
+
+
+void
+MainWindow::onComplianceAbort() {
+    switch(presentMeasure) {
+    case RvsTSourceI:
+    case RvsTSourceV:
+        stopRvsT();
+        break;
+    case RvsTimeSourceI:
+    case RvsTimeSourceV:
+        stopRvsTime();
+        break;
+    case IvsV:
+    case IvsVSourceI:
+    case IvsVSourceV:
+        stopIvsV();
+        break;
+    case LambdaScanI:
+    case LambdaScanV:
+        stopLambdaScan();
+        break;
+    default:
+        return;
+    }
+    logMessage(QString("Measure Aborted after %1 Compliance Events")
+               .arg(pKeithley->MAX_COMPLIANCE_EVENTS));
+    ui->statusBar->showMessage("Measure Aborted: Too Many Compliance Events");
+}
+
+
+// With the Skip policy the readings taken
+// in compliance are not written
+bool
+MainWindow::isReadingToSkip() {
+    return (pConfigureDialog->pTabK236->iCompliancePolicy == Keithley236::ComplianceSkip) &&
+           pKeithley->isReadingInCompliance();
 }
 
 
@@ -1607,11 +2203,28 @@ MainWindow::onKeithleyReadyForSweepTrigger() {
 
 void
 MainWindow::onNewRvsTKeithleyReading(QDateTime dataTime, QString sDataRead) {
-    Q_UNUSED(dataTime)
     double current, voltage;
     if(!DecodeReadings(sDataRead, &current, &voltage))
         return;
-    currentTemperature = pLakeShore->getTemperature();
+    addRvsTPoint(dataTime, current, voltage, 0.0);
+}
+
+
+// In Delta Mode the source and the measure are the half
+// differences of two readings taken with opposite bias
+void
+MainWindow::onNewRvsTDeltaReading(QDateTime dataTime, double dSource, double dMeasure, double dOffset) {
+    if(pConfigureDialog->pTabK236->bSourceI)
+        addRvsTPoint(dataTime, dSource, dMeasure, dOffset);
+    else
+        addRvsTPoint(dataTime, dMeasure, dSource, dOffset);
+}
+
+
+void
+MainWindow::addRvsTPoint(QDateTime dataTime, double current, double voltage, double offset) {
+    double dTError;
+    currentTemperature = temperatureAt(dataTime, &dTError);
     ui->temperatureEdit->setText(QString("%1").arg(currentTemperature));
     ui->currentEdit->setText(QString("%1").arg(current, 10, 'g', 4, ' '));
     ui->voltageEdit->setText(QString("%1").arg(voltage, 10, 'g', 4, ' '));
@@ -1621,11 +2234,32 @@ MainWindow::onNewRvsTKeithleyReading(QDateTime dataTime, QString sDataRead) {
     }
 
     if(!bRunning) return;
+    if(isReadingToSkip()) return;
 
+    bool bDelta = pConfigureDialog->pTabK236->bDelta;
+    // Only the dark readings are comparable among themselves.
+    // In Delta Mode the raw readings include the offset.
+    double dMeasure = pConfigureDialog->pTabK236->bSourceI ? voltage : current;
+    if(currentLampStatus == LAMP_OFF) {
+        adaptKeithleySpeed(fabs(dMeasure)+fabs(offset));
+        dRowMeasure = 0.0;
+    }
+    // The bias must fit both the dark and the photo readings
+    dRowMeasure = qMax(dRowMeasure, fabs(dMeasure)+fabs(offset));
+    // The trigger of the next grid point is anticipated by the
+    // (smoothed) delay between the trigger and the reading
+    if(bTGridActive && (currentLampStatus == LAMP_OFF)) {
+        double dDelay = double(pKeithley->getTriggerTime().msecsTo(dataTime));
+        if(dDelay >= 0.0)
+            gridLatency = (gridLatency == 0.0) ? dDelay : 0.8*gridLatency + 0.2*dDelay;
+    }
     QString sData = QString("%1 %2 %3")
                             .arg(currentTemperature, 12, 'g', 6, ' ')
                             .arg(voltage, 12, 'g', 6, ' ')
                             .arg(current, 12, 'g', 6, ' ');
+    if(bDelta)
+        sData += QString(" %1").arg(offset, 12, 'g', 6, ' ');
+    sData += QString(" %1").arg(dTError, 12, 'g', 3, ' ');
     pOutputFile->write(sData.toLocal8Bit());
     if(currentLampStatus == LAMP_OFF) {
         if(voltage != 0.0) {
@@ -1640,19 +2274,40 @@ MainWindow::onNewRvsTKeithleyReading(QDateTime dataTime, QString sDataRead) {
             pPlotMeasurements->UpdatePlot();
         }
         pOutputFile->write("\n");
+        // Change the bias only at the end of a data row
+        trackExcitation(dRowMeasure, QString("T=%1[K]").arg(currentTemperature));
         pOutputFile->flush();
         switchLampOff();
     }
+    // Do not pair readings taken with different illumination
+    if(bDelta)
+        pKeithley->resetDelta();
 }
 
 
 void
 MainWindow::onNewRvsTimeKeithleyReading(QDateTime dateTime, QString sDataRead) {
-    double current, voltage, elapsedTime;
+    double current, voltage;
     if(!DecodeReadings(sDataRead, &current, &voltage))
         return;
-    elapsedTime = double(dateStart.secsTo(dateTime));
-    currentTemperature = pLakeShore->getTemperature();
+    addRvsTimePoint(dateTime, current, voltage, 0.0);
+}
+
+
+void
+MainWindow::onNewRvsTimeDeltaReading(QDateTime dataTime, double dSource, double dMeasure, double dOffset) {
+    if(pConfigureDialog->pTabK236->bSourceI)
+        addRvsTimePoint(dataTime, dSource, dMeasure, dOffset);
+    else
+        addRvsTimePoint(dataTime, dMeasure, dSource, dOffset);
+}
+
+
+void
+MainWindow::addRvsTimePoint(QDateTime dateTime, double current, double voltage, double offset) {
+    double elapsedTime = double(dateStart.msecsTo(dateTime))/1000.0;
+    double dTError;
+    currentTemperature = temperatureAt(dateTime, &dTError);
     ui->temperatureEdit->setText(QString("%1").arg(currentTemperature));
     ui->currentEdit->setText(QString("%1").arg(current, 10, 'g', 4, ' '));
     ui->voltageEdit->setText(QString("%1").arg(voltage, 10, 'g', 4, ' '));
@@ -1662,13 +2317,20 @@ MainWindow::onNewRvsTimeKeithleyReading(QDateTime dateTime, QString sDataRead) {
     }
 
     if(!bRunning) return;
+    if(isReadingToSkip()) return;
 
-    QString sData = QString("%1 %2 %3 %4\n")
+    double dMeasure = pConfigureDialog->pTabK236->bSourceI ? voltage : current;
+    adaptKeithleySpeed(fabs(dMeasure)+fabs(offset));
+    QString sData = QString("%1 %2 %3 %4")
                             .arg(elapsedTime, 12, 'g', 6, ' ')
                             .arg(voltage, 12, 'g', 6, ' ')
                             .arg(current, 12, 'g', 6, ' ')
                             .arg(currentTemperature, 12, 'g', 6, ' ');
+    if(pConfigureDialog->pTabK236->bDelta)
+        sData += QString(" %1").arg(offset, 12, 'g', 6, ' ');
+    sData += QString(" %1\n").arg(dTError, 12, 'g', 3, ' ');
     pOutputFile->write(sData.toLocal8Bit());
+    trackExcitation(fabs(dMeasure)+fabs(offset), QString("Time=%1[s]").arg(elapsedTime));
     pOutputFile->flush();
     if(current != 0.0) {
         pPlotMeasurements->NewPoint(iPlotDark, elapsedTime, voltage/current);
@@ -1677,39 +2339,940 @@ MainWindow::onNewRvsTimeKeithleyReading(QDateTime dateTime, QString sDataRead) {
 }
 
 
-bool
-MainWindow::DecodeReadings(QString sDataRead, double *current, double *voltage) {    // Decode readings
-    QStringList sMeasures = QStringList(sDataRead.split(",", QString::SkipEmptyParts));
+// Invoked when a whole burst of R vs Time readings
+// has been acquired in the Keithley 236 Sweep Buffer
+void
+MainWindow::onRvsTimeBurstDone(QDateTime dataTime, QString sData) {
+    Q_UNUSED(dataTime)
+    QStringList sMeasures = QStringList(sData.split(",", QString::SkipEmptyParts));
     if(sMeasures.count() < 2) {
-        logMessage("Measurement Format Error");
-        return false;
+        logMessage(QString(Q_FUNC_INFO) + QString(" No Burst Values"));
+        if(!bRunning) return;
+        // Nothing to save: just repeat the burst
+        connect(pKeithley, SIGNAL(readyForTrigger()),
+                this, SLOT(onKeithleyReadyForSweepTrigger()));
+        pKeithley->rearmSweep();
+        return;
     }
-    currentTemperature = pLakeShore->getTemperature();
-    if(pConfigureDialog->pTabK236->bSourceI) {
-        *current = sMeasures.at(0).toDouble();
-        *voltage = sMeasures.at(1).toDouble();
+    // The time of each point is reconstructed from the trigger
+    // time and the programmed delay and integration time
+    double tStart = double(dateStart.msecsTo(pKeithley->getTriggerTime()))/1000.0;
+    double dPeriod = pKeithley->getBurstPeriod();
+    double current = 0.0, voltage = 0.0, elapsedTime, dTError;
+    for(int i=0; i<sMeasures.count()-1; i+=2) {
+        if(presentMeasure == RvsTimeSourceI) {
+            current = sMeasures.at(i).toDouble();
+            voltage = sMeasures.at(i+1).toDouble();
+        }
+        else {
+            voltage = sMeasures.at(i).toDouble();
+            current = sMeasures.at(i+1).toDouble();
+        }
+        elapsedTime = tStart + double(i/2+1)*dPeriod;
+        currentTemperature = temperatureAt(dateStart.addMSecs(qint64(elapsedTime*1000.0)), &dTError);
+        QString sLine = QString("%1 %2 %3 %4 %5\n")
+                                .arg(elapsedTime, 12, 'g', 8, ' ')
+                                .arg(voltage, 12, 'g', 6, ' ')
+                                .arg(current, 12, 'g', 6, ' ')
+                                .arg(currentTemperature, 12, 'g', 6, ' ')
+                                .arg(dTError, 12, 'g', 3, ' ');
+        pOutputFile->write(sLine.toLocal8Bit());
+        if(current != 0.0)
+            pPlotMeasurements->NewPoint(iPlotDark, elapsedTime, voltage/current);
     }
-    else {
-        *current = sMeasures.at(1).toDouble();
-        *voltage = sMeasures.at(0).toDouble();
+    pOutputFile->flush();
+    pPlotMeasurements->UpdatePlot();
+    ui->temperatureEdit->setText(QString("%1").arg(currentTemperature));
+    ui->currentEdit->setText(QString("%1").arg(current, 10, 'g', 4, ' '));
+    ui->voltageEdit->setText(QString("%1").arg(voltage, 10, 'g', 4, ' '));
+    if(!bRunning) return;
+    // Repeat the same burst without reprogramming the sweep
+    connect(pKeithley, SIGNAL(readyForTrigger()),
+            this, SLOT(onKeithleyReadyForSweepTrigger()));
+    pKeithley->rearmSweep();
+}
+
+
+// A quick I-V around zero at the fastest speed to check the
+// sample before a long measurement. Returns false if the
+// pre-scan cannot be started.
+bool
+MainWindow::startPreScan() {
+    bool bSourceI = pConfigureDialog->pTabK236->bSourceI;
+    double dAmplitude = qAbs(pConfigureDialog->pTabK236->dStart);
+    if(dAmplitude == 0.0)
+        dAmplitude = bSourceI ? 1.0e-6 : 0.1;
+    double dStep = 2.0*dAmplitude/double(preScanPoints-1);
+    sweepProgram.clear();
+    sweepProgram.setMaxChunkPoints(pKeithley->MAX_SWEEP_POINTS);
+    sweepProgram.addSegment(SweepSegment(bSourceI, -dAmplitude, dAmplitude, dStep,
+                                         preScanDelay, pConfigureDialog->pTabK236->dCompliance));
+    pKeithley->setSpeedProfile(Keithley236::ProfileFastest);
+    connect(pKeithley, SIGNAL(readyForTrigger()),
+            this, SLOT(onKeithleyReadyForSweepTrigger()), Qt::UniqueConnection);
+    connect(pKeithley, SIGNAL(sweepDone(QDateTime,QString)),
+            this, SLOT(onPreScanDone(QDateTime,QString)));
+    if(!pKeithley->initSweepProgram(sweepProgram.chunk(0))) {
+        disconnect(pKeithley, SIGNAL(readyForTrigger()),
+                   this, SLOT(onKeithleyReadyForSweepTrigger()));
+        disconnect(pKeithley, SIGNAL(sweepDone(QDateTime,QString)),
+                   this, SLOT(onPreScanDone(QDateTime,QString)));
+        logMessage(QString(Q_FUNC_INFO) + QString(" Unable to Start the Pre-scan"));
+        return false;
     }
+    ui->startRvsTButton->setDisabled(true);
+    ui->startRvsTimeButton->setDisabled(true);
+    ui->startIvsVButton->setDisabled(true);
+    ui->lambdaScanButton->setDisabled(true);
+    ui->lampButton->setDisabled(true);
+    ui->statusBar->showMessage("Pre-scan of the Sample...Please Wait");
     return true;
 }
 
 
 void
-MainWindow::onNewLambdaScanKeithleyReading(QDateTime dataTime, QString sDataRead) {
+MainWindow::onPreScanDone(QDateTime dataTime, QString sData) {
     Q_UNUSED(dataTime)
-    double current, voltage;
-    if(!DecodeReadings(sDataRead, &current, &voltage))
-        return;
+    disconnect(pKeithley, SIGNAL(readyForTrigger()),
+               this, SLOT(onKeithleyReadyForSweepTrigger()));
+    disconnect(pKeithley, SIGNAL(sweepDone(QDateTime,QString)),
+               this, SLOT(onPreScanDone(QDateTime,QString)));
+    bool bSourceI = pConfigureDialog->pTabK236->bSourceI;
+    QStringList sMeasures = QStringList(sData.split(",", QString::SkipEmptyParts));
+    QVector<double> source, measure;
+    for(int i=0; i<sMeasures.count()-1; i+=2) {
+        source.append(sMeasures.at(i).toDouble());
+        measure.append(sMeasures.at(i+1).toDouble());
+    }
+    if(!preScan.analyze(bSourceI, source, measure)) {
+        sPreScanResult = QString("# Pre-scan Failed\n");
+        logMessage("Pre-scan Failed: Using the Configured Values");
+    }
+    else {
+        bool bApply = pConfigureDialog->pTabK236->bApplyPreScan && preScan.isOhmic();
+        if(bApply) {
+            bApply = pConfigureDialog->pTabK236->applyPreScan(preScan.proposedSourceI(),
+                                                              preScan.proposedBias(),
+                                                              preScan.proposedCompliance());
+            if(!bApply)
+                logMessage("Pre-scan: Proposed Values out of Range");
+        }
+        sPreScanResult = QString("# Pre-scan R=%1[Ohm] Non_Linearity=%2[%] Proposed Source=%3 Bias=%4 Compliance=%5 %6\n")
+                         .arg(preScan.resistance(), 0, 'g', 4)
+                         .arg(100.0*preScan.nonLinearity(), 0, 'g', 3)
+                         .arg(preScan.proposedSourceI() ? "I" : "V")
+                         .arg(preScan.proposedBias(), 0, 'g', 3)
+                         .arg(preScan.proposedCompliance(), 0, 'g', 3)
+                         .arg(bApply ? "Applied" : "Not_Applied");
+        logMessage(sPreScanResult.mid(2).trimmed());
+        if(!preScan.isOhmic())
+            logMessage("Pre-scan: the Sample does not look Ohmic");
+    }
+    // Do not reprogram the Keithley from inside its callback
+    QTimer::singleShot(0, this, SLOT(onPreScanFinished()));
+}
+
+
+void
+MainWindow::onPreScanFinished() {
+    if(iPreScanConfiguration == iConfRvsT) {
+        ui->startRvsTButton->setEnabled(true);
+        startRvsT();
+    }
+    else if(iPreScanConfiguration == iConfRvsTime) {
+        ui->startRvsTimeButton->setEnabled(true);
+        startRvsTime();
+    }
+}
+
+
+void
+MainWindow::writePreScanHeader() {
+    if(!sPreScanResult.isEmpty())
+        pOutputFile->write(sPreScanResult.toLocal8Bit());
+}
+
+
+// Changes the Keithley 236 bias, when needed, to keep the
+// measure inside the compliance window and writes the new
+// value in the data file
+void
+MainWindow::trackExcitation(double dMeasure, QString sWhere) {
+    if(!pConfigureDialog->pTabK236->bTrackExcitation)
+        return;
+    double dNewBias;
+    double dBias = pKeithley->getBias();
+    if(!excitation.update(dBias, dMeasure, pKeithley->getCompliance(), &dNewBias))
+        return;
+    if(!pKeithley->setBias(dNewBias)) {
+        logMessage(QString("Unable to Change the Bias to %1").arg(dNewBias));
+        return;
+    }
+    pOutputFile->write(QString("# Bias=%1 %2\n")
+                       .arg(dNewBias)
+                       .arg(sWhere).toLocal8Bit());
+    logMessage(QString("Bias Changed from %1 to %2 at %3")
+               .arg(dBias)
+               .arg(dNewBias)
+               .arg(sWhere));
+    // The noise must be observed again with the new bias
+    measureNoise.reset(noiseWindow);
+    if(pConfigureDialog->pTabK236->bDelta)
+        pKeithley->resetDelta();
+}
+
+
+void
+MainWindow::writeSpeedProfileHeader() {
+    if(pConfigureDialog->pTabK236->iSpeedProfile == Keithley236::ProfileAdaptive)
+        pOutputFile->write(QString("# Speed_Profile=%1 Precision=%2[%]\n")
+                           .arg(pConfigureDialog->pTabK236->speedProfileName())
+                           .arg(pConfigureDialog->pTabK236->dPrecision).toLocal8Bit());
+    else
+        pOutputFile->write(QString("# Speed_Profile=%1\n")
+                           .arg(pConfigureDialog->pTabK236->speedProfileName()).toLocal8Bit());
+}
+
+
+// Collects the measured values and, every noiseWindow readings,
+// asks the Keithley 236 for the fastest settings giving the
+// required precision on the present measure
+void
+MainWindow::adaptKeithleySpeed(double dMeasure) {
+    if(pConfigureDialog->pTabK236->iSpeedProfile != Keithley236::ProfileAdaptive)
+        return;
+    measureNoise.addValue(dMeasure);
+    if(!measureNoise.isReady())
+        return;
+    double dNoise = measureNoise.relativeNoise();
+    if(pKeithley->adaptSpeedProfile(dNoise,
+                                    pConfigureDialog->pTabK236->dPrecision/100.0,
+                                    dMeasure))
+    {
+        logMessage(QString("K236 %1 (Relative Noise=%2)")
+                   .arg(pKeithley->getSpeedSettings())
+                   .arg(dNoise));
+    }
+    // The noise must be observed again with the new settings
+    measureNoise.reset(noiseWindow);
+}
+
+
+bool
+MainWindow::DecodeReadings(QString sDataRead, double *current, double *voltage) {    // Decode readings
+    QStringList sMeasures = QStringList(sDataRead.split(",", QString::SkipEmptyParts));
+    if(sMeasures.count() < 2) {
+        logMessage("Measurement Format Error");
+        return false;
+    }
+    if(pConfigureDialog->pTabK236->bSourceI) {
+        *current = sMeasures.at(0).toDouble();
+        *voltage = sMeasures.at(1).toDouble();
+    }
+    else {
+        *current = sMeasures.at(1).toDouble();
+        *voltage = sMeasures.at(0).toDouble();
+    }
+    return true;
+}
+
+
+// The Thermostat is read in background: every consumer
+// gets the latest value from the sampler cache
+void
+MainWindow::startTemperatureSampler() {
+    int msInterval = int(pConfigureDialog->pTabLS330->dTSampling*1000.0);
+    temperatureSeries.reset(temperatureSeriesSize);
+    pTSampler->startSampling(msInterval, pConfigureDialog->pTabLS330->bTOnSampleReady);
+}
+
+
+void
+MainWindow::onNewTemperature(QDateTime sampleTime, double dTemperature, double dHeater) {
+    temperatureSeries.addSample(sampleTime.toMSecsSinceEpoch(), dTemperature);
+    // dHeater < 0 when the heater output is unknown
+    if(pMoveModel || bRecordingZone) {
+        double dSeconds = double(moveStartTime.msecsTo(sampleTime))/1000.0;
+        if(pMoveModel)
+            pMoveModel->addSample(dSeconds, dTemperature, dHeater);
+        if(bRecordingZone)
+            pidZones.addSample(dSeconds, dTemperature, dHeater);
+    }
+    if(bRunning && bTGridActive)
+        planGridTrigger();
+    updateHeaterRange();
+    if(!bCheckingTStability)
+        return;
+    thermalStability.addSample(double(thermalStartTime.msecsTo(sampleTime))/1000.0,
+                               dTemperature);
+    if(thermalStability.isStable())
+        onThermalStability();
+}
+
+
+// Foresee when the ramp will cross the next grid temperature
+// and arm the trigger if that happens before the next sample
+void
+MainWindow::planGridTrigger() {
+    if(tGrid.isDone() || (currentLampStatus == LAMP_ON))
+        return;
+    if(gridTimer.isActive())
+        return;
+    QDateTime now = QDateTime::currentDateTime();
+    double dTError;
+    double T = temperatureAt(now, &dTError);
+    if(tGrid.isPassed(T)) {
+        gridTimer.start(0);
+        return;
+    }
+    double dRate;// [K/s]
+    if(!temperatureSeries.slope(gridRateSamples, &dRate))
+        dRate = tGrid.direction()*pConfigureDialog->pTabLS330->dTRate/60.0;
+    if(dRate*tGrid.direction() <= 0.0)// Not moving toward the target
+        return;
+    double msToTarget = 1000.0*(tGrid.target()-T)/dRate - gridLatency;
+    if(msToTarget > 1.5*pTSampler->interval())
+        return;// Wait for a newer sample
+    gridTimer.start(qMax(0, int(msToTarget)));
+}
+
+
+void
+MainWindow::onTimeToTriggerOnGrid() {
+    // The photo reading of the previous point is still pending:
+    // the next temperature sample will retry
+    if(currentLampStatus == LAMP_ON)
+        return;
+    if(!getNewMeasure())
+        logMessage(QString("K236 Busy at the Grid Point T=%1[K]").arg(tGrid.target()));
+    tGrid.advance();
+    // Skip the points already passed by the ramp
+    double dTError;
+    double T = temperatureAt(QDateTime::currentDateTime(), &dTError);
+    while(!tGrid.isDone() && tGrid.isPassed(T)) {
+        logMessage(QString("Grid Point T=%1[K] Skipped").arg(tGrid.target()));
+        tGrid.advance();
+    }
+}
+
+
+// The non linear R vs T ramps are streamed by the host.
+// Returns false when the instrument ramp is used.
+bool
+MainWindow::buildTemperatureProfile() {
+    tProfile.clear();
+    int iShape = pConfigureDialog->pTabLS330->iTProfile;
+    if(iShape == TemperatureProfile::InstrumentRamp)
+        return false;
+    double dTStart = pConfigureDialog->pTabLS330->dTStart;
+    double dTStop  = pConfigureDialog->pTabLS330->dTStop;
+    double dTRate  = pConfigureDialog->pTabLS330->dTRate;
+    // 1000/T and log(T) need positive temperatures
+    if(!tProfile.addRamp(TemperatureProfile::shape(iShape), dTStart, dTStop, dTRate))
+        tProfile.addRamp(TemperatureProfile::LinearT, dTStart, dTStop, dTRate);
+    if(pConfigureDialog->pTabLS330->iFinalDwell > 0)
+        tProfile.addDwell(dTStop, 60.0*pConfigureDialog->pTabLS330->iFinalDwell);
+    return true;
+}
+
+
+// Expected duration of the R vs T ramp [min]
+double
+MainWindow::rampMinutes() {
+    bool bRvsT = (presentMeasure == RvsTSourceI) ||
+                 (presentMeasure == RvsTSourceV);
+    if(bRvsT && buildTemperatureProfile())
+        return tProfile.duration()/60.0;
+    return qAbs(pConfigureDialog->pTabLS330->dTStop -
+                pConfigureDialog->pTabLS330->dTStart) /
+           pConfigureDialog->pTabLS330->dTRate;
+}
+
+
+bool
+MainWindow::startTemperatureProfile() {
+    buildTemperatureProfile();
+    // With the instrument ramp enabled each new set point
+    // would be reached at the RAMPR rate
+    if(!pLakeShore->stopRamp())
+        return false;
+    profileStartTime = QDateTime::currentDateTime();
+    if(!pLakeShore->setTemperature(tProfile.setPoint(0.0)))
+        return false;
+    maxTrackingError  = 0.0;
+    sumTrackingError2 = 0.0;
+    nTrackingSamples  = 0;
+    bTrackingLost     = false;
+    connect(&profileTimer, SIGNAL(timeout()),
+            this, SLOT(onTimeToUpdateSetPoint()));
+    profileTimer.start(profileInterval);
+    bHostProfile = true;
+    logMessage(QString("T Profile Started: %1 min Expected").arg(tProfile.duration()/60.0));
+    return true;
+}
+
+
+void
+MainWindow::onTimeToUpdateSetPoint() {
+    qint64 msStart = profileStartTime.toMSecsSinceEpoch();
+    // Tracking error at the time of the latest temperature sample
+    double dT;
+    qint64 msecs;
+    if(pTSampler->getLatest(&dT, &msecs) && (msecs > msStart)) {
+        double dError = dT - tProfile.setPoint(double(msecs-msStart)/1000.0);
+        maxTrackingError = qMax(maxTrackingError, qAbs(dError));
+        sumTrackingError2 += dError*dError;
+        nTrackingSamples++;
+        if(!bTrackingLost && (qAbs(dError) > trackingTolerance)) {
+            bTrackingLost = true;
+            logMessage(QString("T=%1[K] is not Following the Profile (Error=%2 K)")
+                       .arg(dT).arg(dError));
+        }
+        else if(bTrackingLost && (qAbs(dError) < 0.5*trackingTolerance)) {
+            bTrackingLost = false;
+            logMessage(QString("T=%1[K] is Following the Profile again").arg(dT));
+        }
+    }
+    double dElapsed = double(profileStartTime.msecsTo(QDateTime::currentDateTime()))/1000.0;
+    if(!tProfile.isDone(dElapsed)) {
+        // A busy bus just delays the update to the next tick
+        pLakeShore->trySetTemperature(tProfile.setPoint(dElapsed));
+        return;
+    }
+    profileTimer.stop();
+    profileTimer.disconnect();
+    pLakeShore->setTemperature(tProfile.finalT());
+    double dRmsError = nTrackingSamples > 0 ? sqrt(sumTrackingError2/nTrackingSamples) : 0.0;
+    logMessage(QString("T Profile Done: Max Error=%1 K RMS Error=%2 K")
+               .arg(maxTrackingError).arg(dRmsError));
+    if(pOutputFile)
+        pOutputFile->write(QString("# T_Profile Done Max_Error=%1[K] RMS_Error=%2[K]\n")
+                           .arg(maxTrackingError)
+                           .arg(dRmsError).toLocal8Bit());
+}
+
+
+void
+MainWindow::writeTProfileHeader() {
+    if(!buildTemperatureProfile())
+        return;
+    QStringList sShapes = QStringList() << "Ramp" << "Linear_T" << "Linear_1000/T" << "Log_T";
+    pOutputFile->write(QString("# T_Profile=%1 Duration=%2[min] Final_Dwell=%3[min] SetPoint_Interval=%4[ms]\n")
+                       .arg(sShapes.at(pConfigureDialog->pTabLS330->iTProfile))
+                       .arg(tProfile.duration()/60.0)
+                       .arg(pConfigureDialog->pTabLS330->iFinalDwell)
+                       .arg(profileInterval).toLocal8Bit());
+}
+
+
+// Heating and cooling responses of the cryostat differ
+ThermalModel*
+MainWindow::modelFor(double dStep) {
+    return (dStep >= 0.0) ? &heatingModel : &coolingModel;
+}
+
+
+// The models identified in the previous sessions
+void
+MainWindow::loadThermalModel(ThermalModel* pModel, QString sName) {
+    QSettings settings;
+    pModel->setParameters(settings.value("ThermalModel"+sName+"Gain", 0.0).toDouble(),
+                          settings.value("ThermalModel"+sName+"Tau", 0.0).toDouble(),
+                          settings.value("ThermalModel"+sName+"DeadTime", 0.0).toDouble());
+}
+
+
+void
+MainWindow::saveThermalModel(ThermalModel* pModel, QString sName) {
+    QSettings settings;
+    settings.setValue("ThermalModel"+sName+"Gain", pModel->gain());
+    settings.setValue("ThermalModel"+sName+"Tau", pModel->tau());
+    settings.setValue("ThermalModel"+sName+"DeadTime", pModel->deadTime());
+}
+
+
+// Ratio between the commanded and the true set point step
+// (1 means no boost)
+double
+MainWindow::boostRatio(double dSetPoint, double dStep) {
+    if(!pConfigureDialog->pTabLS330->bBoostSetPoint)
+        return 1.0;
+    if(qAbs(dStep) < minModelStep)
+        return 1.0;
+    ThermalModel* pModel = modelFor(dStep);
+    if(!pModel->isValid())
+        return 1.0;
+    double dOvershoot = qMin((boostFactor-1.0)*qAbs(dStep), maxBoost);
+    if(dStep < 0.0)// No negative set points
+        dOvershoot = qMin(dOvershoot, dSetPoint);
+    double dBoost = 1.0 + dOvershoot/qAbs(dStep);
+    if(pModel->boostTime(dBoost) <= 0.0)
+        return 1.0;
+    return dBoost;
+}
+
+
+// [s] (negative if the thermal response is still unknown)
+double
+MainWindow::predictedReachingTime(double dFrom, double dTo) {
+    double dStep = dTo - dFrom;
+    ThermalModel* pModel = modelFor(dStep);
+    if(!pModel->isValid())
+        return -1.0;
+    double dBoost = boostRatio(dTo, dStep);
+    if(dBoost > 1.0)
+        return pModel->boostTime(dBoost) + pModel->deadTime();
+    return pModel->timeToSetPoint(dStep, thermalBand);
+}
+
+
+// [min] The waiting time is the upper limit
+double
+MainWindow::reachingMinutes(double dFrom, double dTo) {
+    double dMaxWait = pConfigureDialog->pTabLS330->iReachingTStart;
+    double dSeconds = predictedReachingTime(dFrom, dTo);
+    if(dSeconds < 0.0)
+        return dMaxWait;
+    return qMin(dSeconds/60.0, dMaxWait);
+}
+
+
+// The unboosted moves are recorded to identify the thermal
+// response; once it is known the move can be shortened by
+// commanding a larger step for the time predicted by the model
+void
+MainWindow::moveToSetPoint(double dSetPoint) {
+    boostTimer.stop();
+    boostTimer.disconnect();
+    double dT0 = sampledTemperature();
+    double dStep = dSetPoint - dT0;
+    double dBoost = boostRatio(dSetPoint, dStep);
+    double dSeconds = predictedReachingTime(dT0, dSetPoint);
+    moveSetPoint = dSetPoint;
+    moveStartT   = dT0;
+    bZonesUploaded = false;
+    if(pConfigureDialog->pTabLS330->bUploadPidZones)
+        uploadPidZones();
+    if(dBoost > 1.0) {
+        double dCommand = dT0 + dBoost*dStep;
+        double dBoostTime = modelFor(dStep)->boostTime(dBoost);
+        pLakeShore->setTemperature(dCommand);
+        boostTimer.setSingleShot(true);
+        connect(&boostTimer, SIGNAL(timeout()),
+                this, SLOT(onBoostDone()));
+        boostTimer.start(int(1000.0*dBoostTime));
+        logMessage(QString("Set Point Boosted to %1 K for %2 s")
+                   .arg(dCommand).arg(dBoostTime));
+        pMoveModel = Q_NULLPTR;
+    }
+    else {
+        pLakeShore->setTemperature(dSetPoint);
+        pMoveModel = modelFor(dStep);
+        pMoveModel->startMove(dT0, dSetPoint);
+    }
+    setHeaterRange(heaterRangeFor(dSetPoint, dStep > 0.0 ? minHeatingRate : 0.0));
+    // The heater-to-sample plant is identified from the boosted moves too
+    pidZones.startMove(dSetPoint, iHeaterRange);
+    bRecordingZone = (iHeaterRange > 0);
+    moveStartTime = QDateTime::currentDateTime();
+    if(dSeconds >= 0.0)
+        logMessage(QString("T=%1[K] Expected in %2 s").arg(dSetPoint).arg(dSeconds));
+}
+
+
+void
+MainWindow::onBoostDone() {
+    boostTimer.disconnect();
+    pLakeShore->setTemperature(moveSetPoint);
+    logMessage(QString("Set Point Restored to %1 K").arg(moveSetPoint));
+}
+
+
+// Invoked when the Thermostat has settled at the new set point
+void
+MainWindow::endSetPointMove() {
+    // The measure must not start with a boosted set point
+    if(boostTimer.isActive()) {
+        boostTimer.stop();
+        onBoostDone();
+    }
+    if(bRecordingZone) {
+        bRecordingZone = false;
+        if(qAbs(moveSetPoint-moveStartT) >= minModelStep)
+            addSettleTime(double(moveStartTime.msecsTo(QDateTime::currentDateTime()))/1000.0);
+        if(pidZones.fitMove(maxZoneDeadTime)) {
+            int iZone = pidZones.zoneOf(moveSetPoint);
+            PidZoneTable::Zone zone = pidZones.zone(iZone);
+            savePidZone(iZone);
+            logMessage(QString("Plant in Zone %1 (T<=%2 K): Gain=%3 K/% Tau=%4 s Dead Time=%5 s Heater=%6 % on Range %7")
+                       .arg(iZone+1)
+                       .arg(zone.dTopT)
+                       .arg(zone.dGain)
+                       .arg(zone.dTau)
+                       .arg(zone.dDeadTime)
+                       .arg(zone.dOutput)
+                       .arg(zone.iRange));
+        }
+    }
+    if(pMoveModel == Q_NULLPTR)
+        return;
+    ThermalModel* pModel = pMoveModel;
+    pMoveModel = Q_NULLPTR;
+    if(!pModel->fitMove(minModelStep))
+        return;
+    QString sName = (pModel == &heatingModel) ? QString("Heating") : QString("Cooling");
+    saveThermalModel(pModel, sName);
+    logMessage(QString("Thermal Model (%1): Gain=%2 Tau=%3 s Dead Time=%4 s Heater=%5 %")
+               .arg(sName)
+               .arg(pModel->gain())
+               .arg(pModel->tau())
+               .arg(pModel->deadTime())
+               .arg(pModel->heaterOutput()));
+}
+
+
+void
+MainWindow::writeThermalModelHeader() {
+    QString sLine = QString("# T_Model");
+    if(heatingModel.isValid())
+        sLine += QString(" Heating_Gain=%1 Heating_Tau=%2[s] Heating_Dead_Time=%3[s]")
+                 .arg(heatingModel.gain())
+                 .arg(heatingModel.tau())
+                 .arg(heatingModel.deadTime());
+    if(coolingModel.isValid())
+        sLine += QString(" Cooling_Gain=%1 Cooling_Tau=%2[s] Cooling_Dead_Time=%3[s]")
+                 .arg(coolingModel.gain())
+                 .arg(coolingModel.tau())
+                 .arg(coolingModel.deadTime());
+    if(!heatingModel.isValid() && !coolingModel.isValid())
+        sLine += QString("=Unknown");
+    sLine += QString(" Boost=%1").arg(pConfigureDialog->pTabLS330->bBoostSetPoint ? "On" : "Off");
+    sLine += QString(" PID_Zones=%1\n").arg(pConfigureDialog->pTabLS330->bUploadPidZones ? "Identified" : "Stored");
+    pOutputFile->write(sLine.toLocal8Bit());
+}
+
+
+void
+MainWindow::loadPidZones() {
+    QSettings settings;
+    for(int i=0; i<pidZones.count(); i++) {
+        QString sKey = QString("PIDZone%1").arg(i+1);
+        PidZoneTable::Zone zone = pidZones.zone(i);
+        zone.nMoves    = settings.value(sKey+"Moves", 0).toInt();
+        zone.dGain     = settings.value(sKey+"Gain", 0.0).toDouble();
+        zone.dTau      = settings.value(sKey+"Tau", 0.0).toDouble();
+        zone.dDeadTime = settings.value(sKey+"DeadTime", 0.0).toDouble();
+        zone.dOutput   = settings.value(sKey+"Output", 0.0).toDouble();
+        zone.iRange    = settings.value(sKey+"Range", 3).toInt();
+        if((zone.dGain <= 0.0) || (zone.dTau <= 0.0) ||
+           (zone.iRange < 1) || (zone.iRange > 3))
+            zone.nMoves = 0;
+        pidZones.setZone(i, zone);
+    }
+}
+
+
+void
+MainWindow::savePidZone(int iZone) {
+    QSettings settings;
+    QString sKey = QString("PIDZone%1").arg(iZone+1);
+    PidZoneTable::Zone zone = pidZones.zone(iZone);
+    settings.setValue(sKey+"Moves", zone.nMoves);
+    settings.setValue(sKey+"Gain", zone.dGain);
+    settings.setValue(sKey+"Tau", zone.dTau);
+    settings.setValue(sKey+"DeadTime", zone.dDeadTime);
+    settings.setValue(sKey+"Output", zone.dOutput);
+    settings.setValue(sKey+"Range", zone.iRange);
+}
+
+
+// The table is logged only when it changes
+void
+MainWindow::uploadPidZones() {
+    if(!pidZones.isIdentified())
+        return;
+    QStringList sZones;
+    for(int i=0; i<pidZones.count(); i++) {
+        PidZoneTable::Pid pid = pidZones.pid(i);
+        double dTopT = pidZones.zone(i).dTopT;
+        if(!pLakeShore->setZone(i+1, dTopT, pid.iRange, pid.dP, pid.dI, pid.dD))
+            return;
+        sZones.append(QString("Zone %1: T<=%2 K P=%3 I=%4 D=%5 Range=%6")
+                      .arg(i+1)
+                      .arg(dTopT)
+                      .arg(pid.dP, 0, 'f', 1)
+                      .arg(pid.dI, 0, 'f', 1)
+                      .arg(pid.dD, 0, 'f', 0)
+                      .arg(pid.iRange));
+    }
+    bZonesUploaded = true;
+    QString sTable = sZones.join("\n");
+    if(sTable == sUploadedZones)
+        return;
+    sUploadedZones = sTable;
+    logMessage(QString("PID Zones Uploaded:\n") + sTable);
+}
+
+
+// Settling times of the moves with the PID stored in the
+// Thermostat and with the identified zones, kept across sessions
+void
+MainWindow::addSettleTime(double dSeconds) {
+    QSettings settings;
+    QString sKey = bZonesUploaded ? QString("PIDZonesSettleIdentified") : QString("PIDZonesSettleStored");
+    settings.setValue(sKey+"Sum", settings.value(sKey+"Sum", 0.0).toDouble()+dSeconds);
+    settings.setValue(sKey+"Moves", settings.value(sKey+"Moves", 0).toInt()+1);
+    int nStored     = settings.value("PIDZonesSettleStoredMoves", 0).toInt();
+    int nIdentified = settings.value("PIDZonesSettleIdentifiedMoves", 0).toInt();
+    double dStored     = nStored > 0 ?
+                         settings.value("PIDZonesSettleStoredSum", 0.0).toDouble()/nStored : 0.0;
+    double dIdentified = nIdentified > 0 ?
+                         settings.value("PIDZonesSettleIdentifiedSum", 0.0).toDouble()/nIdentified : 0.0;
+    logMessage(QString("Settled in %1 s (%2 Zones). Mean: %3 s over %4 Moves before, %5 s over %6 Moves after the Zone Upload")
+               .arg(dSeconds)
+               .arg(bZonesUploaded ? "Identified" : "Stored")
+               .arg(dStored).arg(nStored)
+               .arg(dIdentified).arg(nIdentified));
+}
+
+
+// The lowest range that holds the set point and heats at the
+// required rate [K/min], according to the identified plant
+int
+MainWindow::heaterRangeFor(double dSetPoint, double dHeatingRate) {
+    int iRange = pidZones.rangeFor(dSetPoint, dHeatingRate);
+    if(iRange == 0)
+        return defaultHeaterRange;
+    return iRange;
+}
+
+
+void
+MainWindow::setHeaterRange(int iRange, bool bWaitBus) {
+    bool bDone = bWaitBus ? pLakeShore->switchPowerOn(iRange)
+                          : pLakeShore->trySwitchPowerOn(iRange);
+    if(!bDone)
+        return;
+    if(iRange == iHeaterRange)
+        return;
+    iHeaterRange = iRange;
+    logMessage(QString("Heater Range %1 at T=%2 K").arg(iRange).arg(currentTemperature));
+    if(bRunning && pOutputFile)
+        pOutputFile->write(QString("# T=%1[K] Heater_Range=%2\n")
+                           .arg(currentTemperature)
+                           .arg(iRange).toLocal8Bit());
+}
+
+
+// During the ramps the range follows the set point.
+// Invoked at each new temperature sample
+void
+MainWindow::updateHeaterRange() {
+    if(!bRunning)
+        return;
+    bool bRvsT = (presentMeasure == RvsTSourceI) ||
+                 (presentMeasure == RvsTSourceV);
+    bool bRvsTime = (presentMeasure == RvsTimeSourceI) ||
+                    (presentMeasure == RvsTimeSourceV);
+    if(!bRvsT && !(bRvsTime && pConfigureDialog->pTabLS330->bUseThermostat))
+        return;
+    // In Zone mode the Thermostat switches the range by itself
+    if(pConfigureDialog->pTabLS330->bUploadPidZones && bZonesUploaded)
+        return;
+    double dTStart = pConfigureDialog->pTabLS330->dTStart;
+    double dTStop  = pConfigureDialog->pTabLS330->dTStop;
+    double dSetPoint;
+    if(bHostProfile) {
+        dSetPoint = tProfile.setPoint(double(profileStartTime.msecsTo(QDateTime::currentDateTime()))/1000.0);
+    }
+    else {// The Thermostat ramps its set point from T Start at T Rate
+        double dRamp = pConfigureDialog->pTabLS330->dTRate *
+                       double(rampStartTime.msecsTo(QDateTime::currentDateTime()))/60000.0;
+        if(dTStop > dTStart)
+            dSetPoint = qMin(dTStart+dRamp, dTStop);
+        else
+            dSetPoint = qMax(dTStart-dRamp, dTStop);
+    }
+    bool bHeating = dTStop > dTStart;
+    int iRange = heaterRangeFor(dSetPoint, bHeating ? pConfigureDialog->pTabLS330->dTRate : 0.0);
+    // Retried at the next sample if the bus is busy
+    if(iRange != iHeaterRange)
+        setHeaterRange(iRange, false);
+}
+
+
+void
+MainWindow::writeHeaterRangeHeader() {
+    // The changes are recorded among the data
+    pOutputFile->write(QString("# Heater_Range=%1 Holding_T_Start=%2\n")
+                       .arg(pidZones.isIdentified() ? "Auto" : "Default")
+                       .arg(heaterRangeFor(pConfigureDialog->pTabLS330->dTStart, 0.0)).toLocal8Bit());
+}
+
+
+// The statistics of the temperature samples decide when
+// the Thermostat has settled at the new set point
+void
+MainWindow::startThermalStabilityCheck(double dSetPoint) {
+    if(!pConfigureDialog->pTabLS330->bDetectTStability)
+        return;
+    thermalStability.reset(dSetPoint, thermalWindow, thermalBand,
+                           thermalMaxSlope, thermalMaxSigma);
+    thermalStartTime = QDateTime::currentDateTime();
+    bCheckingTStability = true;
+}
+
+
+// The fixed waiting and stabilization times are only upper limits:
+// the measure goes on as soon as the temperature is steady
+void
+MainWindow::onThermalStability() {
+    bCheckingTStability = false;
+    double dElapsed = double(thermalStartTime.msecsTo(QDateTime::currentDateTime()))/1000.0;
+    logMessage(QString("T Stable after %1 s (Slope=%2 K/min Sigma=%3 K Overshoot=%4 K)")
+               .arg(dElapsed)
+               .arg(thermalStability.slope())
+               .arg(thermalStability.sigma())
+               .arg(thermalStability.overshoot()));
+    if(pOutputFile)
+        pOutputFile->write(QString("# T=%1[K] Thermally Stable after %2[s] Overshoot=%3[K]\n")
+                           .arg(sampledTemperature())
+                           .arg(dElapsed)
+                           .arg(thermalStability.overshoot()).toLocal8Bit());
+    bool bWaiting = waitingTStartTimer.isActive();
+    waitingTStartTimer.stop();
+    waitingTStartTimer.disconnect();
+    // The sweeps leave presentMeasure to IvsVSourceI/IvsVSourceV
+    bool bIvsV = (presentMeasure == IvsV)        ||
+                 (presentMeasure == IvsVSourceI) ||
+                 (presentMeasure == IvsVSourceV);
+    if(bIvsV) {
+        if(bWaiting)
+            startThermalStabilization();
+        // The electrical stability, when required, has the last word
+        if(!pConfigureDialog->pTabK236->bStabilityCheck)
+            onSteadyTReached();
+    }
+    else {
+        onTimerStabilizeT();
+    }
+}
+
+
+// The fixed T Step or, when required, a step adapted
+// to the change of the I-V curves between set points
+double
+MainWindow::nextTStep() {
+    if(!pConfigureDialog->pTabLS330->bAdaptiveTStep)
+        return pConfigureDialog->pTabLS330->dTStep;
+    tStepScheduler.addCurve(setPointT, sweepVoltages, sweepCurrents);
+    double dStep = tStepScheduler.nextStep();
+    // Do not skip T Stop
+    double dTStop = pConfigureDialog->pTabLS330->dTStop;
+    if((setPointT < dTStop) && (setPointT+dStep > dTStop))
+        dStep = dTStop - setPointT;
+    pOutputFile->write(QString("# I-V_Change=%1[%] Next_T_Step=%2[K]\n")
+                       .arg(100.0*tStepScheduler.lastChange())
+                       .arg(dStep).toLocal8Bit());
+    return dStep;
+}
+
+
+// The ramp status comes from the sampler cache, so that the
+// GUI never waits for the bus. A status older than the start
+// of the ramp means "still ramping" until the next sample
+bool
+MainWindow::isThermostatRamping() {
+    if(bHostProfile)
+        return profileTimer.isActive();
+    LakeShore330::Status status;
+    qint64 msecs;
+    if(pTSampler->getLatestStatus(&status, &msecs)) {
+        if(msecs <= rampStartTime.toMSecsSinceEpoch())
+            return true;
+        return status.bRamping;
+    }
+    // Without the batched status the ramp lasts as expected
+    double dMinutes = qAbs(pConfigureDialog->pTabLS330->dTStop -
+                           pConfigureDialog->pTabLS330->dTStart) /
+                      pConfigureDialog->pTabLS330->dTRate;
+    return QDateTime::currentDateTime() < rampStartTime.addMSecs(qint64(dMinutes*60000.0));
+}
+
+
+void
+MainWindow::writeTStabilityHeader() {
+    if(!pConfigureDialog->pTabLS330->bDetectTStability)
+        return;
+    pOutputFile->write(QString("# T_Stability=Detected Window=%1[s] Band=%2[K] Max_Slope=%3[K/min] Max_Sigma=%4[K]\n")
+                       .arg(thermalWindow)
+                       .arg(thermalBand)
+                       .arg(thermalMaxSlope)
+                       .arg(thermalMaxSigma).toLocal8Bit());
+}
+
+
+// Temperature at the acquisition time of a reading, interpolated
+// from the samples of the Thermostat around it
+double
+MainWindow::temperatureAt(QDateTime dataTime, double* pError) {
+    TemperatureSeries::method iMethod = TemperatureSeries::Linear;
+    if(pConfigureDialog->pTabLS330->bCubicT)
+        iMethod = TemperatureSeries::Cubic;
+    double T;
+    if(!temperatureSeries.interpolate(dataTime.toMSecsSinceEpoch(), iMethod, &T, pError)) {
+        *pError = 0.0;
+        return sampledTemperature();
+    }
+    return T;
+}
+
+
+void
+MainWindow::writeTInterpolationHeader() {
+    if(pConfigureDialog->pTabLS330->bTOnSampleReady)
+        pOutputFile->write(QString("# T_Interpolation=%1 T_Sampling=Sample_Data_Ready Max_Interval=%2[s]\n")
+                           .arg(pConfigureDialog->pTabLS330->bCubicT ? "Cubic" : "Linear")
+                           .arg(pConfigureDialog->pTabLS330->dTSampling).toLocal8Bit());
+    else
+        pOutputFile->write(QString("# T_Interpolation=%1 T_Sampling=%2[s]\n")
+                           .arg(pConfigureDialog->pTabLS330->bCubicT ? "Cubic" : "Linear")
+                           .arg(pConfigureDialog->pTabLS330->dTSampling).toLocal8Bit());
+}
+
+
+double
+MainWindow::sampledTemperature() {
+    double T;
+    qint64 msecs;
+    if(!pTSampler->getLatest(&T, &msecs)) {
+        logMessage(QString(Q_FUNC_INFO) + QString(" No Temperature Available"));
+        return currentTemperature;
+    }
+    qint64 age = QDateTime::currentMSecsSinceEpoch() - msecs;
+    if(age > qint64(maxTemperatureAge)*pTSampler->interval())
+        logMessage(QString("Stale Temperature: %1[K] read %2[s] ago")
+                   .arg(T)
+                   .arg(double(age)/1000.0));
+    return T;
+}
+
+
+void
+MainWindow::onNewLambdaScanKeithleyReading(QDateTime dataTime, QString sDataRead) {
+    Q_UNUSED(dataTime)
+    double current, voltage;
+    if(!DecodeReadings(sDataRead, &current, &voltage))
+        return;
     double lambda = pCornerStone130->dPresentWavelength;
+    currentTemperature = sampledTemperature();
     ui->temperatureEdit->setText(QString("%1").arg(currentTemperature));
     ui->currentEdit->setText(QString("%1").arg(current, 10, 'g', 4, ' '));
     ui->voltageEdit->setText(QString("%1").arg(voltage, 10, 'g', 4, ' '));
     ui->wavelengthEdit->setText(QString("%1").arg(lambda, 10, 'f', 1, ' '));
 
     if(!bRunning) return;
+    if(isReadingToSkip()) return;
 
     if(currentLampStatus == LAMP_OFF) {
         QString sData = QString("%1 %2 %3 %4")
@@ -1746,48 +3309,80 @@ MainWindow::onNewLambdaScanKeithleyReading(QDateTime dataTime, QString sDataRead
 void
 MainWindow::onKeithleySweepDone(QDateTime dataTime, QString sData) {
     Q_UNUSED(dataTime)
-    disconnect(pKeithley, SIGNAL(sweepDone(QDateTime,QString)), this, Q_NULLPTR);
     ui->statusBar->showMessage("Sweep Done: Decoding readings...Please wait");
     QStringList sMeasures = QStringList(sData.split(",", QString::SkipEmptyParts));
     if(sMeasures.count() < 2) {
+        disconnect(pKeithley, SIGNAL(sweepDone(QDateTime,QString)), this, Q_NULLPTR);
         stopIvsV();
         ui->statusBar->showMessage(QString(Q_FUNC_INFO) + QString(" Error: No Sweep Values"));
         onClearComplianceEvent();
         return;
     }
-    ui->statusBar->showMessage("Sweep Done: Updating Plot...Please wait");
-    double current, voltage;
-    for(int i=0; i<sMeasures.count(); i+=2) {
-        if(presentMeasure == IvsVSourceI) {
-            current = sMeasures.at(i).toDouble();
-            voltage = sMeasures.at(i+1).toDouble();
+    if(bAverageSweeps) {
+        // Each pair is made of Source and Measure values
+        if(sweepStatistics.sweeps() == 0)
+            sweepStatistics.reset(sMeasures.count()/2);
+        sweepStatistics.startSweep();
+        for(int i=0; i<sMeasures.count()-1; i+=2) {
+            sweepStatistics.addValue(i/2,
+                                     sMeasures.at(i).toDouble(),
+                                     sMeasures.at(i+1).toDouble());
         }
-        else {
-            voltage = sMeasures.at(i).toDouble();
-            current = sMeasures.at(i+1).toDouble();
+        int nSweeps = sweepStatistics.sweeps();
+        double dError = sweepStatistics.relativeError();
+        bool bConverged = (nSweeps >= minSweepRepeats) &&
+                          (dError <= pConfigureDialog->pTabK236->dTargetError/100.0);
+        if(!bConverged && (nSweeps < pConfigureDialog->pTabK236->iMaxRepeats)) {
+            ui->statusBar->showMessage(QString("Sweep %1 Done (Rel. Error=%2%): Sweeping...Please wait")
+                                       .arg(nSweeps)
+                                       .arg(dError*100.0, 0, 'g', 3));
+            // Repeat the same sweep without reprogramming it
+            connect(pKeithley, SIGNAL(readyForTrigger()),
+                    this, SLOT(onKeithleyReadyForSweepTrigger()));
+            pKeithley->rearmSweep();
+            return;
         }
-        QString sData = QString("%1 %2 %3\n")
-                .arg(voltage, 12, 'g', 6, ' ')
-                .arg(current, 12, 'g', 6, ' ')
-                .arg(currentTemperature, 12, 'g', 6, ' ');
-        pOutputFile->write(sData.toLocal8Bit());
-        pPlotMeasurements->NewPoint(1, voltage, current);
     }
+    disconnect(pKeithley, SIGNAL(sweepDone(QDateTime,QString)), this, Q_NULLPTR);
+    QVector<SweepSegment> doneSegments = sweepProgram.chunk(iSweepChunk);
+    // Start the next chunk (if any) before decoding the present
+    // one, so that the Keithley 236 sweeps while we write and plot
+    iSweepChunk++;
+    bool bLastChunk = (iSweepChunk >= sweepProgram.chunks());
+    if(!bLastChunk) {
+        ui->statusBar->showMessage(QString("Sweeping Chunk %1 of %2...Please Wait")
+                                   .arg(iSweepChunk+1)
+                                   .arg(sweepProgram.chunks()));
+        if(!programSweepChunk())
+            return;
+    }
+    else {
+        ui->statusBar->showMessage("Sweep Done: Updating Plot...Please wait");
+    }
+    currentTemperature = sampledTemperature();
+    writeSweepChunk(doneSegments, sMeasures);
     pPlotMeasurements->UpdatePlot();
     pOutputFile->flush();
+    sweepStatistics.reset(0);
+    if(!bLastChunk)
+        return;
     if(pConfigureDialog->pTabLS330->bUseThermostat) {
-        setPointT += pConfigureDialog->pTabLS330->dTStep;
+        setPointT += nextTStep();
         if(setPointT > pConfigureDialog->pTabLS330->dTStop) {
             stopIvsV();
             ui->statusBar->showMessage("Measure Done");
             onClearComplianceEvent();
             return;
         }
+        // Waiting for the next set point, as at the measure start
+        presentMeasure = IvsV;
         isK236ReadyForTrigger = false;
         connect(pKeithley, SIGNAL(complianceEvent()),
-                this, SLOT(onComplianceEvent()));
+                this, SLOT(onComplianceEvent()),
+                Qt::UniqueConnection);
         connect(pKeithley, SIGNAL(clearCompliance()),
-                this, SLOT(onClearComplianceEvent()));
+                this, SLOT(onClearComplianceEvent()),
+                Qt::UniqueConnection);
         connect(pKeithley, SIGNAL(readyForTrigger()),
                 this, SLOT(onKeithleyReadyForSweepTrigger()));
         connect(&waitingTStartTimer, SIGNAL(timeout()),
@@ -1796,8 +3391,8 @@ MainWindow::onKeithleySweepDone(QDateTime dataTime, QString sData) {
         // Start the reaching of the Next Temperature
         waitingTStartTimer.start(5000);
         // Configure Thermostat
-        pLakeShore->setTemperature(setPointT);
-        pLakeShore->switchPowerOn(3);
+        moveToSetPoint(setPointT);
+        startThermalStabilityCheck(setPointT);
         ui->statusBar->showMessage(QString("%1 Waiting Next T [%2K]")
                                    .arg(waitingTStartTime.toString())
                                    .arg(setPointT));
@@ -1810,100 +3405,133 @@ MainWindow::onKeithleySweepDone(QDateTime dataTime, QString sData) {
 }
 
 
+// Writes, segment by segment, the points of a chunk of the sweep program.
+// When averaging, the mean values are written together with
+// their standard error
 void
-MainWindow::onIForwardSweepDone(QDateTime dataTime, QString sData) {
-    Q_UNUSED(dataTime)
-    ui->statusBar->showMessage("Reverse Direction: Sweeping...Please Wait");
-    disconnect(pKeithley, SIGNAL(sweepDone(QDateTime,QString)), this, Q_NULLPTR);
-    QStringList sMeasures = QStringList(sData.split(",", QString::SkipEmptyParts));
-    if(sMeasures.count() < 2) {
-        logMessage(QString(Q_FUNC_INFO) + QString(" No Sweep Values "));
-        return;
-    }
-    double current, voltage;
-    for(int i=0; i<sMeasures.count(); i+=2) {
-        if(presentMeasure == IvsVSourceI) {
-            current = sMeasures.at(i).toDouble();
-            voltage = sMeasures.at(i+1).toDouble();
+MainWindow::writeSweepChunk(QVector<SweepSegment> segments, QStringList sMeasures) {
+    int nPoints = sMeasures.count()/2;
+    if(bAverageSweeps) {
+        nPoints = sweepStatistics.points();
+        pOutputFile->write(QString("# Sweeps=%1 Relative_Error=%2[%]\n")
+                           .arg(sweepStatistics.sweeps())
+                           .arg(sweepStatistics.relativeError()*100.0).toLocal8Bit());
+    }
+    double source, measure, current, voltage;
+    int iPoint = 0;
+    for(int iSegment=0; iSegment<segments.count(); iSegment++) {
+        const SweepSegment& segment = segments.at(iSegment);
+        // The last segment takes all the remaining points
+        int iLast = nPoints;
+        if(iSegment < segments.count()-1)
+            iLast = qMin(nPoints, iPoint+segment.points());
+        // A segment continuing from the previous chunk
+        // must look as a single segment
+        if((sweepProgram.segments() > 1) && !segment.bContinued) {
+            pOutputFile->write(QString("# Segment Source=%1 Start=%2 Stop=%3\n")
+                               .arg(segment.bSourceI ? "I" : "V")
+                               .arg(segment.dStart)
+                               .arg(segment.dStop).toLocal8Bit());
         }
-        else {
-            voltage = sMeasures.at(i).toDouble();
-            current = sMeasures.at(i+1).toDouble();
+        for(; iPoint<iLast; iPoint++) {
+            if(bAverageSweeps) {
+                source  = sweepStatistics.source(iPoint);
+                measure = sweepStatistics.mean(iPoint);
+            }
+            else {
+                source  = sMeasures.at(2*iPoint).toDouble();
+                measure = sMeasures.at(2*iPoint+1).toDouble();
+            }
+            if(segment.bSourceI) {
+                current = source;
+                voltage = measure;
+            }
+            else {
+                voltage = source;
+                current = measure;
+            }
+            sweepVoltages.append(voltage);
+            sweepCurrents.append(current);
+            QString sData = QString("%1 %2 %3")
+                    .arg(voltage, 12, 'g', 6, ' ')
+                    .arg(current, 12, 'g', 6, ' ')
+                    .arg(currentTemperature, 12, 'g', 6, ' ');
+            if(bAverageSweeps)
+                sData += QString(" %1").arg(sweepStatistics.standardError(iPoint), 12, 'g', 6, ' ');
+            sData += QString("\n");
+            pOutputFile->write(sData.toLocal8Bit());
+            pPlotMeasurements->NewPoint(1, voltage, current);
         }
-        pOutputFile->write(QString("%1 %2 %3\n")
-                           .arg(voltage, 12, 'g', 6, ' ')
-                           .arg(current, 12, 'g', 6, ' ')
-                           .arg(setPointT, 12, 'g', 6, ' ')
-                           .toLocal8Bit());
-        pPlotMeasurements->NewPoint(1, voltage, current);
     }
-    pPlotMeasurements->UpdatePlot();
-    pOutputFile->flush();
-    double dVStart;
-    double dVStop;
-    if(junctionDirection > 0) {// Forward junction
-        dVStart = pConfigureDialog->pTabK236->dStart;
-        dVStop = 0.0;
-    }
-    else {// Reverse Junction
-        dVStart = 0.0;
-        dVStop = pConfigureDialog->pTabK236->dStop;
-    }
-    int nSweepPoints = pConfigureDialog->pTabK236->iNSweepPoints;
-    double dVStep = qAbs(dVStop - dVStart) / double(nSweepPoints);
-    double dDelayms = double(pConfigureDialog->pTabK236->iWaitTime);
-    double dCompliance = qMax(qAbs(pConfigureDialog->pTabK236->dStart),
-                              qAbs(pConfigureDialog->pTabK236->dStop));
-    presentMeasure = IvsVSourceV;
-    connect(pKeithley, SIGNAL(readyForTrigger()),
-            this, SLOT(onKeithleyReadyForSweepTrigger()));
-    connect(pKeithley, SIGNAL(sweepDone(QDateTime,QString)),
-            this, SLOT(onKeithleySweepDone(QDateTime,QString)));
-    pKeithley->initVSweep(dVStart, dVStop, dVStep, dDelayms, dCompliance);
 }
 
 
+// Invoked for each pair of bias values of the Junction Check
 void
-MainWindow::onVReverseSweepDone(QDateTime dataTime, QString sData) {
-    Q_UNUSED(dataTime)
-    ui->statusBar->showMessage("Forward Direction: Sweeping...Please Wait");
-    disconnect(pKeithley, SIGNAL(sweepDone(QDateTime,QString)), this, Q_NULLPTR);
-    QStringList sMeasures = QStringList(sData.split(",", QString::SkipEmptyParts));
-    if(sMeasures.count() < 2) {
-        logMessage(QString(Q_FUNC_INFO) + QString(" No Sweep Values "));
+MainWindow::onJunctionCheckResult(double vReverse, double iReverse, double vForward, double iForward) {
+    logMessage(QString("Junction Check: I(%1V)=%2A I(%3V)=%4A")
+               .arg(vReverse).arg(iReverse)
+               .arg(vForward).arg(iForward));
+    if((iForward == 0.0) || (iReverse == 0.0))
         return;
-    }
-    double current, voltage;
-    for(int i=0; i<sMeasures.count(); i+=2) {
-        if(presentMeasure == IvsVSourceI) {
-            current = sMeasures.at(i).toDouble();
-            voltage = sMeasures.at(i+1).toDouble();
-        }
-        else {
-            voltage = sMeasures.at(i).toDouble();
-            current = sMeasures.at(i+1).toDouble();
-        }
-        pOutputFile->write(QString("%1 %2 %3\n")
-                           .arg(voltage, 12, 'g', 6, ' ')
-                           .arg(current, 12, 'g', 6, ' ')
-                           .arg(setPointT, 12, 'g', 6, ' ')
-                           .toLocal8Bit());
-        pPlotMeasurements->NewPoint(1, voltage, current);
-    }
-    pPlotMeasurements->UpdatePlot();
-    pOutputFile->flush();
+    // Order of Magnitude Difference between Forward and Reverse Current
+    junctionDirection += qRound(log10(fabs(iForward))) -
+                         qRound(log10(fabs(iReverse)));
+}
+
+
+// Invoked when the Junction Check is over: the I-V
+// measure proceeds with the Forward Current Sweep
+void
+MainWindow::onJunctionCheckDone(bool bSuccess) {
+    disconnect(pKeithley, SIGNAL(junctionCheckResult(double,double,double,double)),
+               this, SLOT(onJunctionCheckResult(double,double,double,double)));
+    disconnect(pKeithley, SIGNAL(junctionCheckDone(bool)),
+               this, SLOT(onJunctionCheckDone(bool)));
     double dIStart = pConfigureDialog->pTabK236->dStart;
-    double dIStop = 0.0;
+    double dIStop = pConfigureDialog->pTabK236->dStop;
     int nSweepPoints = pConfigureDialog->pTabK236->iNSweepPoints;
-    double dIStep = qAbs(dIStop - dIStart) / double(nSweepPoints);
     double dDelayms = double(pConfigureDialog->pTabK236->iWaitTime);
     double dCompliance = pConfigureDialog->pTabK236->dCompliance;
-    presentMeasure = IvsVSourceI;
-    connect(pKeithley, SIGNAL(readyForTrigger()),
-            this, SLOT(onKeithleyReadyForSweepTrigger()));
-    connect(pKeithley, SIGNAL(sweepDone(QDateTime,QString)),
-            this, SLOT(onKeithleySweepDone(QDateTime,QString)));
-    pKeithley->initISweep(dIStart, dIStop, dIStep, dDelayms, dCompliance);
+    sweepProgram.clear();
+    if(!bSuccess) {
+        // Unable to know the junction direction: do a plain sweep
+        logMessage(QString(Q_FUNC_INFO) + QString(" Junction Check Failed"));
+        ui->statusBar->showMessage("Sweeping...Please Wait");
+        double dIStep = qAbs(dIStop - dIStart) / double(nSweepPoints);
+        sweepProgram.addSegment(SweepSegment(true, dIStart, dIStop, dIStep, dDelayms, dCompliance));
+        if(pConfigureDialog->pTabK236->bPulsed)
+            sweepProgram.setPulsed(pConfigureDialog->pTabK236->iPulseOn,
+                                   pConfigureDialog->pTabK236->iPulseOff);
+        startSweepProgram();
+        return;
+    }
+    // Forward Current Sweep...
+    ui->statusBar->showMessage("Forward Direction: Sweeping...Please Wait");
+    dIStop = 0.0;
+    double dIStep = qAbs(dIStop - dIStart) / double(nSweepPoints);
+    sweepProgram.addSegment(SweepSegment(true, dIStart, dIStop, dIStep, dDelayms, dCompliance));
+    // ...followed by the Voltage Sweep in the junction direction.
+    // The current sweep limits are in Ampere: the voltage leg uses
+    // the (already validated) Junction Check voltage and compliance
+    double dJunctionBias = pConfigureDialog->pTabK236->dJunctionBias;
+    double dVStart;
+    double dVStop;
+    if(junctionDirection > 0) {// Forward junction
+        dVStart = (dIStart < 0.0) ? -dJunctionBias : dJunctionBias;
+        dVStop = 0.0;
+    }
+    else {// Reverse Junction
+        dVStart = 0.0;
+        dVStop = (pConfigureDialog->pTabK236->dStop < 0.0) ? -dJunctionBias : dJunctionBias;
+    }
+    double dVStep = qAbs(dVStop - dVStart) / double(nSweepPoints);
+    double dICompliance = pConfigureDialog->pTabK236->dJunctionCompliance;
+    sweepProgram.addSegment(SweepSegment(false, dVStart, dVStop, dVStep, dDelayms, dICompliance));
+    if(pConfigureDialog->pTabK236->bPulsed)
+        sweepProgram.setPulsed(pConfigureDialog->pTabK236->iPulseOn,
+                               pConfigureDialog->pTabK236->iPulseOff);
+    startSweepProgram();
 }
 
 
@@ -23,6 +23,20 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <QTimer>
 
 #include "configuredialog.h"
+#include "noiseestimator.h"
+#include "sweepstatistics.h"
+#include "sweepprogram.h"
+#include "excitationcontroller.h"
+#include "prescan.h"
+#include "settlingtable.h"
+#include "stabilitydetector.h"
+#include "temperatureseries.h"
+#include "thermalstability.h"
+#include "tstepscheduler.h"
+#include "temperaturegrid.h"
+#include "temperatureprofile.h"
+#include "thermalmodel.h"
+#include "pidzonetable.h"
 
 
 
@@ -34,6 +48,7 @@ namespace Ui {
 QT_FORWARD_DECLARE_CLASS(QFile)
 QT_FORWARD_DECLARE_CLASS(Keithley236)
 QT_FORWARD_DECLARE_CLASS(LakeShore330)
+QT_FORWARD_DECLARE_CLASS(TemperatureSampler)
 QT_FORWARD_DECLARE_CLASS(CornerStone130)
 QT_FORWARD_DECLARE_CLASS(Plot2D)
 
@@ -62,9 +77,11 @@ protected:
     void initTemperaturePlot();
     void writeRvsTHeader();
     void initRvsTPlots();
+    void startRvsT();
     void stopRvsT();
     void writeRvsTimeHeader();
     void initRvsTimePlots();
+    void startRvsTime();
     void stopRvsTime();
     void writeIvsVHeader();
     void startI_Vscan(bool bSourceI);
@@ -80,6 +97,54 @@ protected:
     bool prepareLogFile();
     void logMessage(QString sMessage);
     bool DecodeReadings(QString sDataRead, double *current, double *voltage);
+    void writeSpeedProfileHeader();
+    void startSweepProgram();
+    void runSweepProgram();
+    bool startSettlingCheck();
+    bool programSettlingBurst();
+    void startThermalStabilization();
+    void startStabilityCheck();
+    void stopStabilityCheck();
+    bool programSweepChunk();
+    void writeSweepChunk(QVector<SweepSegment> segments, QStringList sMeasures);
+    void adaptKeithleySpeed(double dMeasure);
+    bool isReadingToSkip();
+    void addRvsTPoint(QDateTime dataTime, double current, double voltage, double offset);
+    void addRvsTimePoint(QDateTime dateTime, double current, double voltage, double offset);
+    void trackExcitation(double dMeasure, QString sWhere);
+    bool startPreScan();
+    void writePreScanHeader();
+    void startTemperatureSampler();
+    double sampledTemperature();
+    double temperatureAt(QDateTime dataTime, double* pError);
+    void writeTInterpolationHeader();
+    void startThermalStabilityCheck(double dSetPoint);
+    void onThermalStability();
+    void writeTStabilityHeader();
+    bool isThermostatRamping();
+    double nextTStep();
+    void planGridTrigger();
+    bool buildTemperatureProfile();
+    bool startTemperatureProfile();
+    double rampMinutes();
+    void writeTProfileHeader();
+    ThermalModel* modelFor(double dStep);
+    void loadThermalModel(ThermalModel* pModel, QString sName);
+    void saveThermalModel(ThermalModel* pModel, QString sName);
+    double boostRatio(double dSetPoint, double dStep);
+    double predictedReachingTime(double dFrom, double dTo);
+    double reachingMinutes(double dFrom, double dTo);
+    void moveToSetPoint(double dSetPoint);
+    void endSetPointMove();
+    void writeThermalModelHeader();
+    void loadPidZones();
+    void savePidZone(int iZone);
+    void uploadPidZones();
+    void addSettleTime(double dSeconds);
+    int  heaterRangeFor(double dSetPoint, double dHeatingRate);
+    void setHeaterRange(int iRange, bool bWaitBus=true);
+    void updateHeaterRange();
+    void writeHeaterRangeHeader();
 
 private slots:
     void on_startRvsTButton_clicked();
@@ -91,16 +156,29 @@ private slots:
     void onSteadyTReached();
     void onTimeToReadT();
     void onTimeToGetNewMeasure();
+    void onTimeToTriggerOnGrid();
+    void onTimeToUpdateSetPoint();
+    void onBoostDone();
     void onComplianceEvent();
     void onClearComplianceEvent();
+    void onComplianceRaise();
+    void onComplianceAbort();
+    void onPreScanDone(QDateTime dataTime, QString sData);
+    void onPreScanFinished();
+    void onSettlingBurstDone(QDateTime dataTime, QString sData);
+    void onStabilityReading(QDateTime dataTime, QString sDataRead);
     void onKeithleyReadyForTrigger();
+    void onNewTemperature(QDateTime sampleTime, double dTemperature, double dHeater);
     void onNewRvsTKeithleyReading(QDateTime dataTime, QString sDataRead);
     void onNewRvsTimeKeithleyReading(QDateTime dataTime, QString sDataRead);
+    void onNewRvsTDeltaReading(QDateTime dataTime, double dSource, double dMeasure, double dOffset);
+    void onNewRvsTimeDeltaReading(QDateTime dataTime, double dSource, double dMeasure, double dOffset);
+    void onRvsTimeBurstDone(QDateTime dataTime, QString sData);
     void onNewLambdaScanKeithleyReading(QDateTime dataTime, QString sDataRead);
     bool onKeithleyReadyForSweepTrigger();
     void onKeithleySweepDone(QDateTime dataTime, QString sData);
-    void onIForwardSweepDone(QDateTime, QString sData);
-    void onVReverseSweepDone(QDateTime, QString sData);
+    void onJunctionCheckResult(double vReverse, double iReverse, double vForward, double iForward);
+    void onJunctionCheckDone(bool bSuccess);
     void on_lampButton_clicked();
     void onLogMessage(QString sMessage);
     void on_lambdaScanButton_clicked();
@@ -128,6 +206,7 @@ private:
     QFile           *pLogFile;
     Keithley236     *pKeithley;
     LakeShore330    *pLakeShore;
+    TemperatureSampler *pTSampler;
     CornerStone130  *pCornerStone130;
     Plot2D          *pPlotMeasurements;
     Plot2D          *pPlotTemperature;
@@ -149,11 +228,37 @@ private:
     QTimer           stabilizingTimer;
     QTimer           readingTTimer;
     QTimer           measuringTimer;
+    QTimer           gridTimer;
+    QTimer           profileTimer;
+    QTimer           boostTimer;
 
     const quint8     LAMP_ON    = 1;
     const quint8     LAMP_OFF   = 0;
     const int        iPlotDark  = 1;
     const int        iPlotPhoto = 2;
+    const int        minSweepRepeats = 3;
+    const int        preScanPoints   = 5;
+    const double     preScanDelay    = 50.0;// [ms]
+    const double     settlingTolerance = 0.001;
+    const int        stabilityInterval = 2000;// [ms]
+    const int        stabilityWindow   = 15;// Readings
+    const double     stabilityBias     = 0.1;// Fraction of the sweep amplitude
+    const int        maxTemperatureAge = 3;// Sampling intervals
+    const int        temperatureSeriesSize = 256;// Samples
+    const double     thermalWindow   = 120.0;// [s]
+    const double     thermalBand     = 0.15;// [K]
+    const double     thermalMaxSlope = 0.05;// [K/min]
+    const double     thermalMaxSigma = 0.05;// [K]
+    const double     tStepTargetChange = 0.1;// Relative change of the I-V between set points
+    const int        gridRateSamples   = 5;// Temperature samples used to estimate the ramp rate
+    const int        profileInterval   = 2000;// [ms] between the streamed set points
+    const double     trackingTolerance = 1.0;// [K] from the profile
+    const double     minModelStep      = 1.0;// [K] Smaller moves are not fitted nor boosted
+    const double     boostFactor       = 1.5;// Commanded over true set point step
+    const double     maxBoost          = 10.0;// [K] Max set point overshoot
+    const double     maxZoneDeadTime   = 300.0;// [s] Searched in the PID zone identification
+    const int        defaultHeaterRange = 3;// While the plant is unknown
+    const double     minHeatingRate    = 1.0;// [K/min] Required to the heating steps
 
     double           currentTemperature;
     double           setPointT;
@@ -172,6 +277,53 @@ private:
     double           sigmaDark;
     double           sigmaIll;
     double           wlResolution;
+    NoiseEstimator   measureNoise;
+    int              noiseWindow;
+    SweepStatistics  sweepStatistics;
+    bool             bAverageSweeps;
+    SweepProgram     sweepProgram;
+    int              iSweepChunk;
+    double           sweepChunkTime;
+    ExcitationController excitation;
+    double           dRowMeasure;
+    PreScan          preScan;
+    int              iPreScanConfiguration;
+    QString          sPreScanResult;
+    SettlingTable    settlingTable;
+    QVector<SweepSegment> settlingSteps;
+    int              iSettlingStep;
+    StabilityDetector stabilityDetector;
+    QDateTime        stabilityStartTime;
+    bool             bCheckingStability;
+    TemperatureSeries temperatureSeries;
+    ThermalStabilityDetector thermalStability;
+    QDateTime        thermalStartTime;
+    QDateTime        rampStartTime;
+    TStepScheduler   tStepScheduler;
+    QVector<double>  sweepVoltages;
+    QVector<double>  sweepCurrents;
+    bool             bCheckingTStability;
+    TemperatureGrid  tGrid;
+    bool             bTGridActive;
+    double           gridLatency;// [ms] from trigger to reading
+    TemperatureProfile tProfile;
+    QDateTime        profileStartTime;
+    bool             bHostProfile;
+    double           maxTrackingError;
+    double           sumTrackingError2;
+    int              nTrackingSamples;
+    bool             bTrackingLost;
+    ThermalModel     heatingModel;
+    ThermalModel     coolingModel;
+    ThermalModel*    pMoveModel;// The model being identified (if any)
+    QDateTime        moveStartTime;
+    double           moveSetPoint;
+    double           moveStartT;
+    PidZoneTable     pidZones;
+    bool             bRecordingZone;
+    bool             bZonesUploaded;// For the present move
+    QString          sUploadedZones;
+    int              iHeaterRange;// Last commanded
 
     QString          sLogFileName;
     QString          sLogDir;
@@ -0,0 +1,93 @@
+/*
+ *
+Copyright (C) 2016  Gabriele Salvato
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*/
+#include "noiseestimator.h"
+
+#include <QtMath>
+
+
+NoiseEstimator::NoiseEstimator()
+    : nWindow(0)
+    , iNext(0)
+    , nValues(0)
+{
+    reset(10);
+}
+
+
+// Forget all the values and prepare a circular
+// buffer of windowSize values
+void
+NoiseEstimator::reset(int windowSize) {
+    nWindow = qMax(windowSize, 3);
+    values.fill(0.0, nWindow);
+    iNext   = 0;
+    nValues = 0;
+}
+
+
+void
+NoiseEstimator::addValue(double value) {
+    values[iNext] = value;
+    iNext = (iNext+1) % nWindow;
+    if(nValues < nWindow)
+        nValues++;
+}
+
+
+bool
+NoiseEstimator::isReady() {
+    return nValues == nWindow;
+}
+
+
+double
+NoiseEstimator::lastValue() {
+    if(nValues == 0)
+        return 0.0;
+    return values.at((iNext+nWindow-1) % nWindow);
+}
+
+
+// The standard deviation of the differences of uncorrelated
+// values is sqrt(2) times the standard deviation of the values
+double
+NoiseEstimator::relativeNoise() {
+    if(nValues < 3)
+        return 0.0;
+    int iFirst = (iNext+nWindow-nValues) % nWindow;
+    double sum = 0.0;
+    double sumDiff = 0.0;
+    double sumDiff2 = 0.0;
+    for(int i=0; i<nValues; i++) {
+        double value = values.at((iFirst+i) % nWindow);
+        sum += value;
+        if(i > 0) {
+            double diff = value - values.at((iFirst+i-1) % nWindow);
+            sumDiff  += diff;
+            sumDiff2 += diff*diff;
+        }
+    }
+    int nDiff = nValues-1;
+    double mean = sum/nValues;
+    double meanDiff = sumDiff/nDiff;
+    double varDiff = (sumDiff2 - nDiff*meanDiff*meanDiff)/(nDiff-1);
+    if((mean == 0.0) || (varDiff <= 0.0))
+        return 0.0;
+    return qSqrt(varDiff/2.0)/qAbs(mean);
+}
@@ -0,0 +1,42 @@
+/*
+ *
+Copyright (C) 2016  Gabriele Salvato
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*/
+#pragma once
+
+#include <QVector>
+
+
+// Estimates the relative noise of a slowly drifting quantity
+// from the differences of successive values, so that a ramp
+// of the measured quantity is not mistaken for noise.
+class NoiseEstimator
+{
+public:
+    NoiseEstimator();
+    void   reset(int windowSize);
+    void   addValue(double value);
+    bool   isReady();
+    double relativeNoise();
+    double lastValue();
+
+private:
+    QVector<double> values;
+    int    nWindow;
+    int    iNext;
+    int    nValues;
+};
@@ -0,0 +1,305 @@
+/*
+ *
+Copyright (C) 2016  Gabriele Salvato
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*/
+#include "pidzonetable.h"
+
+#include <QtMath>
+
+
+PidZoneTable::PidZoneTable()
+    : setPoint(0.0)
+    , range(3)
+{
+    // The zones are narrower at low T, where the
+    // thermal response changes faster with T
+    const double topT[] = {10.0, 20.0, 40.0, 70.0, 100.0,
+                           150.0, 200.0, 250.0, 325.0, 475.0};
+    for(int i=0; i<10; i++) {
+        Zone newZone;
+        newZone.dTopT     = topT[i];
+        newZone.nMoves    = 0;
+        newZone.dGain     = 0.0;
+        newZone.dTau      = 0.0;
+        newZone.dDeadTime = 0.0;
+        newZone.dOutput   = 0.0;
+        newZone.iRange    = 3;
+        zones.append(newZone);
+    }
+}
+
+
+int
+PidZoneTable::count() {
+    return zones.count();
+}
+
+
+int
+PidZoneTable::zoneOf(double dTemperature) {
+    for(int i=0; i<zones.count(); i++) {
+        if(dTemperature <= zones.at(i).dTopT)
+            return i;
+    }
+    return zones.count()-1;
+}
+
+
+PidZoneTable::Zone
+PidZoneTable::zone(int iZone) {
+    return zones.at(iZone);
+}
+
+
+void
+PidZoneTable::setZone(int iZone, Zone newZone) {
+    newZone.dTopT = zones.at(iZone).dTopT;
+    zones[iZone] = newZone;
+}
+
+
+bool
+PidZoneTable::isIdentified() {
+    for(int i=0; i<zones.count(); i++) {
+        if(zones.at(i).nMoves > 0)
+            return true;
+    }
+    return false;
+}
+
+
+// The heater ranges differ by a factor 10 in power
+PidZoneTable::Zone
+PidZoneTable::toRange(Zone zone, int iRange) {
+    double dScale = qPow(10.0, double(iRange-zone.iRange));
+    zone.dGain   *= dScale;
+    zone.dOutput /= dScale;
+    zone.iRange   = iRange;
+    return zone;
+}
+
+
+void
+PidZoneTable::startMove(double dSetPoint, int iRange) {
+    times.clear();
+    temperatures.clear();
+    outputs.clear();
+    setPoint = dSetPoint;
+    range    = iRange;
+}
+
+
+// Samples without the heater output (dHeater < 0) are useless
+void
+PidZoneTable::addSample(double dSeconds, double dTemperature, double dHeater) {
+    if((dHeater < 0.0) || (times.count() >= maxSamples))
+        return;
+    times.append(dSeconds);
+    temperatures.append(dTemperature);
+    outputs.append(dHeater);
+}
+
+
+// Heater output at a given time (linearly interpolated)
+double
+PidZoneTable::outputAt(double dSeconds) {
+    if(dSeconds <= times.first())
+        return outputs.first();
+    for(int i=1; i<times.count(); i++) {
+        if(dSeconds <= times.at(i)) {
+            double x = (dSeconds-times.at(i-1))/(times.at(i)-times.at(i-1));
+            return outputs.at(i-1) + x*(outputs.at(i)-outputs.at(i-1));
+        }
+    }
+    return outputs.last();
+}
+
+
+// Least squares fit of dT/dt = Alpha*T + Beta*u(t-DeadTime) + Gamma
+bool
+PidZoneTable::fitPlant(double dDeadTime, double* pAlpha, double* pBeta, double* pResidual) {
+    // Normal equations
+    double a[3][3] = {{0.0, 0.0, 0.0}, {0.0, 0.0, 0.0}, {0.0, 0.0, 0.0}};
+    double b[3] = {0.0, 0.0, 0.0};
+    int nRows = 0;
+    for(int i=0; i<times.count()-1; i++) {
+        if(times.at(i)-dDeadTime < times.first())
+            continue;
+        double dt = times.at(i+1)-times.at(i);
+        if(dt <= 0.0)
+            continue;
+        double x[3] = {temperatures.at(i), outputAt(times.at(i)-dDeadTime), 1.0};
+        double y = (temperatures.at(i+1)-temperatures.at(i))/dt;
+        for(int j=0; j<3; j++) {
+            for(int k=0; k<3; k++)
+                a[j][k] += x[j]*x[k];
+            b[j] += x[j]*y;
+        }
+        nRows++;
+    }
+    if(nRows < minSamples)
+        return false;
+    // Cramer's rule
+    double det = a[0][0]*(a[1][1]*a[2][2]-a[1][2]*a[2][1]) -
+                 a[0][1]*(a[1][0]*a[2][2]-a[1][2]*a[2][0]) +
+                 a[0][2]*(a[1][0]*a[2][1]-a[1][1]*a[2][0]);
+    if(qAbs(det) < 1.0e-12)
+        return false;
+    double c[3];
+    for(int j=0; j<3; j++) {
+        double m[3][3];
+        for(int r=0; r<3; r++) {
+            for(int k=0; k<3; k++)
+                m[r][k] = (k == j) ? b[r] : a[r][k];
+        }
+        c[j] = (m[0][0]*(m[1][1]*m[2][2]-m[1][2]*m[2][1]) -
+                m[0][1]*(m[1][0]*m[2][2]-m[1][2]*m[2][0]) +
+                m[0][2]*(m[1][0]*m[2][1]-m[1][1]*m[2][0])) / det;
+    }
+    double dResidual = 0.0;
+    for(int i=0; i<times.count()-1; i++) {
+        if(times.at(i)-dDeadTime < times.first())
+            continue;
+        double dt = times.at(i+1)-times.at(i);
+        if(dt <= 0.0)
+            continue;
+        double y = (temperatures.at(i+1)-temperatures.at(i))/dt;
+        double r = y - (c[0]*temperatures.at(i) + c[1]*outputAt(times.at(i)-dDeadTime) + c[2]);
+        dResidual += r*r;
+    }
+    *pAlpha    = c[0];
+    *pBeta     = c[1];
+    *pResidual = dResidual/nRows;
+    return true;
+}
+
+
+// The dead time is searched on a grid of steps as long as the
+// mean sampling interval. Returns false if no physical plant
+// (Tau > 0, Gain > 0) fits the move.
+bool
+PidZoneTable::fitMove(double dMaxDeadTime) {
+    if(times.count() < minSamples)
+        return false;
+    double dStep = (times.last()-times.first())/(times.count()-1);
+    if(dStep <= 0.0)
+        return false;
+    double dBestResidual = -1.0;
+    double dAlpha = 0.0, dBeta = 0.0, dDeadTime = 0.0;
+    for(double dTheta=0.0; dTheta<=dMaxDeadTime; dTheta+=dStep) {
+        double alpha, beta, residual;
+        if(!fitPlant(dTheta, &alpha, &beta, &residual))
+            continue;
+        if((alpha >= 0.0) || (beta <= 0.0))
+            continue;
+        if((dBestResidual < 0.0) || (residual < dBestResidual)) {
+            dBestResidual = residual;
+            dAlpha    = alpha;
+            dBeta     = beta;
+            dDeadTime = dTheta;
+        }
+    }
+    if(dBestResidual < 0.0)
+        return false;
+    Zone fitted;
+    fitted.nMoves    = 1;
+    fitted.dTau      = -1.0/dAlpha;
+    fitted.dGain     = -dBeta/dAlpha;
+    fitted.dDeadTime = dDeadTime;
+    fitted.iRange    = range;
+    fitted.dOutput   = 0.0;
+    for(int i=outputs.count()-endSamples; i<outputs.count(); i++)
+        fitted.dOutput += outputs.at(i);
+    fitted.dOutput /= endSamples;
+    // Running mean with the previous moves in the same zone
+    int iZone = zoneOf(setPoint);
+    Zone old = zones.at(iZone);
+    if(old.nMoves > 0) {
+        old = toRange(old, range);
+        double w = 1.0/double(qMin(old.nMoves, 3)+1);
+        fitted.nMoves    = old.nMoves+1;
+        fitted.dTau      = w*fitted.dTau      + (1.0-w)*old.dTau;
+        fitted.dGain     = w*fitted.dGain     + (1.0-w)*old.dGain;
+        fitted.dDeadTime = w*fitted.dDeadTime + (1.0-w)*old.dDeadTime;
+        fitted.dOutput   = w*fitted.dOutput   + (1.0-w)*old.dOutput;
+    }
+    setZone(iZone, fitted);
+    return true;
+}
+
+
+// The zones not yet identified take the plant of the nearest
+// identified one (nMoves is 0 if none is)
+PidZoneTable::Zone
+PidZoneTable::plantOf(int iZone) {
+    Zone plant = zones.at(iZone);
+    for(int d=1; (plant.nMoves == 0) && (d<zones.count()); d++) {
+        if((iZone-d >= 0) && (zones.at(iZone-d).nMoves > 0))
+            plant = zones.at(iZone-d);
+        else if((iZone+d < zones.count()) && (zones.at(iZone+d).nMoves > 0))
+            plant = zones.at(iZone+d);
+    }
+    return plant;
+}
+
+
+// The lowest heater range able to hold dTemperature with less
+// than maxOutput and to heat at dHeatingRate [K/min] with the
+// remaining output. Returns 0 if the plant is still unknown.
+int
+PidZoneTable::rangeFor(double dTemperature, double dHeatingRate) {
+    Zone plant = plantOf(zoneOf(dTemperature));
+    if(plant.nMoves == 0)
+        return 0;
+    for(int iRange=1; iRange<3; iRange++) {
+        Zone scaled = toRange(plant, iRange);
+        double dMaxRate = 60.0*scaled.dGain*(100.0-scaled.dOutput)/scaled.dTau;
+        if((scaled.dOutput <= maxOutput) && (dMaxRate >= dHeatingRate))
+            return iRange;
+    }
+    return 3;
+}
+
+
+// The heater range is the lowest one able to hold
+// the zone with less than maxOutput.
+PidZoneTable::Pid
+PidZoneTable::pid(int iZone) {
+    Zone plant = plantOf(iZone);
+    Pid result;
+    result.dP = 0.0;
+    result.dI = 0.0;
+    result.dD = 0.0;
+    result.iRange = 3;
+    if(plant.nMoves == 0)
+        return result;
+    for(int iRange=1; iRange<=3; iRange++) {
+        if(toRange(plant, iRange).dOutput <= maxOutput) {
+            result.iRange = iRange;
+            break;
+        }
+    }
+    plant = toRange(plant, result.iRange);
+    // SIMC with the closed loop time constant equal to the dead time
+    double dTheta = qMax(plant.dDeadTime, 0.1*plant.dTau);
+    double dKc = plant.dTau/(plant.dGain*2.0*dTheta);
+    double dTi = qMin(plant.dTau, 8.0*dTheta);
+    result.dP = qBound(0.1, dKc, 999.0);
+    result.dI = qBound(0.1, 60.0/dTi, 999.0);
+    result.dD = 0.0;
+    return result;
+}
@@ -0,0 +1,81 @@
+/*
+ *
+Copyright (C) 2016  Gabriele Salvato
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*/
+#pragma once
+
+#include <QVector>
+#include <QString>
+
+
+// The LS330 zone table (up to 10 zones, each one with its own
+// P, I, D and heater range) derived from the set point moves.
+// In every move the heater output u and the temperature T are
+// recorded and the heater-to-sample plant
+//   Tau*dT/dt = -T + Gain*u(t-DeadTime) + const
+// is identified by least squares. The controller parameters
+// follow the SIMC (Skogestad) rules for a PI controller.
+class PidZoneTable
+{
+public:
+    struct Zone {
+        double dTopT;     // [K] upper limit of the zone
+        int    nMoves;    // identified moves (0 = unknown)
+        double dGain;     // [K/%] of the heater output on iRange
+        double dTau;      // [s]
+        double dDeadTime; // [s]
+        double dOutput;   // [%] steady heater output on iRange
+        int    iRange;    // 1=low 2=medium 3=high
+    };
+    struct Pid {
+        double dP;        // Gain [%/K]
+        double dI;        // Reset [repeats/min]
+        double dD;        // Rate [s]
+        int    iRange;
+    };
+
+public:
+    PidZoneTable();
+    int    count();
+    int    zoneOf(double dTemperature);
+    Zone   zone(int iZone);
+    void   setZone(int iZone, Zone newZone);
+    bool   isIdentified();
+    void   startMove(double dSetPoint, int iRange);
+    void   addSample(double dSeconds, double dTemperature, double dHeater);
+    bool   fitMove(double dMaxDeadTime);
+    Pid    pid(int iZone);
+    int    rangeFor(double dTemperature, double dHeatingRate);
+    static Zone toRange(Zone zone, int iRange);
+
+private:
+    double outputAt(double dSeconds);
+    Zone   plantOf(int iZone);
+    bool   fitPlant(double dDeadTime, double* pAlpha, double* pBeta, double* pResidual);
+
+private:
+    QVector<Zone>   zones;
+    QVector<double> times;
+    QVector<double> temperatures;
+    QVector<double> outputs;
+    double setPoint;
+    int    range;
+    const int    maxSamples   = 20000;
+    const int    minSamples   = 20;
+    const int    endSamples   = 5;// Averaged for the steady heater output
+    const double maxOutput    = 70.0;// [%] Highest steady output on the chosen range
+};
@@ -0,0 +1,121 @@
+/*
+ *
+Copyright (C) 2016  Gabriele Salvato
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*/
+#include "prescan.h"
+
+#include <QtMath>
+
+
+PreScan::PreScan()
+    : bValid(false)
+    , dResistance(0.0)
+    , dNonLinearity(0.0)
+    , bProposedSourceI(true)
+    , dProposedBias(0.0)
+    , dProposedCompliance(0.0)
+{
+}
+
+
+// Least squares straight line through the points: the slope gives
+// the resistance and the rms residual, relative to the largest
+// measured value, the deviation from the ohmic behaviour.
+bool
+PreScan::analyze(bool bSourceI, QVector<double> source, QVector<double> measure) {
+    bValid = false;
+    int n = qMin(source.count(), measure.count());
+    if(n < 3)
+        return false;
+    double sx = 0.0, sy = 0.0, sxx = 0.0, sxy = 0.0, yMax = 0.0;
+    for(int i=0; i<n; i++) {
+        sx  += source.at(i);
+        sy  += measure.at(i);
+        sxx += source.at(i)*source.at(i);
+        sxy += source.at(i)*measure.at(i);
+        yMax = qMax(yMax, qAbs(measure.at(i)));
+    }
+    double det = n*sxx - sx*sx;
+    if((det == 0.0) || (yMax == 0.0))
+        return false;
+    double slope  = (n*sxy - sx*sy)/det;
+    double offset = (sy - slope*sx)/n;
+    double sr2 = 0.0;
+    for(int i=0; i<n; i++) {
+        double r = measure.at(i) - (slope*source.at(i)+offset);
+        sr2 += r*r;
+    }
+    dNonLinearity = qSqrt(sr2/n)/yMax;
+    // dV/dI when sourcing I, dI/dV when sourcing V
+    if(slope <= 0.0)
+        return false;
+    dResistance = bSourceI ? slope : 1.0/slope;
+
+    bProposedSourceI = dResistance < sourceVThreshold;
+    if(bProposedSourceI) {
+        dProposedBias = qBound(1.0e-12, targetVoltage/dResistance, 0.1);
+        dProposedCompliance = qBound(1.0, 4.0*dProposedBias*dResistance, 110.0);
+    }
+    else {
+        dProposedBias = targetVoltage;
+        dProposedCompliance = qBound(1.0e-9, 4.0*dProposedBias/dResistance, 0.1);
+    }
+    bValid = true;
+    return true;
+}
+
+
+bool
+PreScan::isValid() {
+    return bValid;
+}
+
+
+bool
+PreScan::isOhmic() {
+    return bValid && (dNonLinearity <= maxNonLinearity);
+}
+
+
+double
+PreScan::resistance() {
+    return dResistance;
+}
+
+
+double
+PreScan::nonLinearity() {
+    return dNonLinearity;
+}
+
+
+bool
+PreScan::proposedSourceI() {
+    return bProposedSourceI;
+}
+
+
+double
+PreScan::proposedBias() {
+    return dProposedBias;
+}
+
+
+double
+PreScan::proposedCompliance() {
+    return dProposedCompliance;
+}
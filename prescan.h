@@ -0,0 +1,55 @@
+/*
+ *
+Copyright (C) 2016  Gabriele Salvato
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*/
+#pragma once
+
+#include <QVector>
+
+
+// Analyzes a few-point I-V around zero, taken before a long
+// measurement, and proposes the source mode, the bias and the
+// compliance to be used for it.
+class PreScan
+{
+public:
+    PreScan();
+    bool   analyze(bool bSourceI, QVector<double> source, QVector<double> measure);
+    bool   isValid();
+    bool   isOhmic();
+    double resistance();
+    double nonLinearity();
+    bool   proposedSourceI();
+    double proposedBias();
+    double proposedCompliance();
+
+public:
+    const double maxNonLinearity = 0.05;
+    // Above this resistance the K236 measures currents
+    // better than it measures voltages
+    const double sourceVThreshold = 1.0e6;// [Ohm]
+    // Aimed measured voltage (about half the 1.1V range)
+    const double targetVoltage = 0.5;
+
+private:
+    bool   bValid;
+    double dResistance;
+    double dNonLinearity;
+    bool   bProposedSourceI;
+    double dProposedBias;
+    double dProposedCompliance;
+};
@@ -0,0 +1,185 @@
+/*
+ *
+Copyright (C) 2016  Gabriele Salvato
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*/
+#include "settlingtable.h"
+#include "keithley236.h"
+
+#include <QtMath>
+
+
+SettlingTable::SettlingTable()
+    : defaultDelay(0.0)
+{
+    reset(0.0);
+}
+
+
+// Forget all the measured delays
+void
+SettlingTable::reset(double dDefaultDelay) {
+    defaultDelay = dDefaultDelay;
+    delaysI.fill(-1.0, Keithley236::rangeCount(false));
+    delaysV.fill(-1.0, Keithley236::rangeCount(true));
+}
+
+
+// The smallest source range containing dSource
+int
+SettlingTable::rangeOf(bool bSourceI, double dSource) const {
+    int nRanges = Keithley236::rangeCount(!bSourceI);
+    for(int i=0; i<nRanges-1; i++) {
+        // Allow for the rounding of the staircase values
+        if(qAbs(dSource) <= Keithley236::fullScale(!bSourceI, i)*(1.0+1.0e-9))
+            return i;
+    }
+    return nRanges-1;
+}
+
+
+void
+SettlingTable::setDelay(bool bSourceI, int iRange, double dDelay) {
+    QVector<double>& delays = bSourceI ? delaysI : delaysV;
+    if((iRange >= 0) && (iRange < delays.count()))
+        delays[iRange] = qMax(dDelay, 0.0);
+}
+
+
+double
+SettlingTable::delay(bool bSourceI, int iRange) const {
+    const QVector<double>& delays = bSourceI ? delaysI : delaysV;
+    if((iRange < 0) || (iRange >= delays.count()) || (delays.at(iRange) < 0.0))
+        return defaultDelay;
+    return delays.at(iRange);
+}
+
+
+// A single point segment for each source range touched by the
+// segments, at the largest level reached in that range
+QVector<SweepSegment>
+SettlingTable::settlingSteps(QVector<SweepSegment> segments) const {
+    QVector<SweepSegment> steps;
+    for(int iSegment=0; iSegment<segments.count(); iSegment++) {
+        const SweepSegment& segment = segments.at(iSegment);
+        double direction = (segment.dStop >= segment.dStart) ? 1.0 : -1.0;
+        for(int k=0; k<segment.points(); k++) {
+            double dValue = segment.dStart + direction*segment.dStep*k;
+            if(qAbs(dValue) < 0.5*segment.dStep)
+                continue;
+            int iRange = rangeOf(segment.bSourceI, dValue);
+            int i = 0;
+            for(; i<steps.count(); i++) {
+                if((steps.at(i).bSourceI == segment.bSourceI) &&
+                   (rangeOf(segment.bSourceI, steps.at(i).dStart) == iRange))
+                    break;
+            }
+            if(i == steps.count()) {
+                steps.append(SweepSegment(segment.bSourceI, dValue, dValue,
+                                          segment.dStep, 0.0, segment.dCompliance));
+            }
+            else if(qAbs(dValue) > qAbs(steps.at(i).dStart)) {
+                steps[i].dStart = dValue;
+                steps[i].dStop  = dValue;
+            }
+        }
+    }
+    return steps;
+}
+
+
+// Splits the segment where the source range changes: each
+// piece gets the delay measured on its own range
+QVector<SweepSegment>
+SettlingTable::split(const SweepSegment& segment) const {
+    QVector<SweepSegment> pieces;
+    if(segment.bPulsed) {
+        pieces.append(segment);
+        return pieces;
+    }
+    double direction = (segment.dStop >= segment.dStart) ? 1.0 : -1.0;
+    int nPoints = segment.points();
+    int iFirst = 0;
+    // A zero source point stays with its neighbours
+    double dFirst = segment.dStart;
+    if((dFirst == 0.0) && (nPoints > 1))
+        dFirst += direction*segment.dStep;
+    int iRange = rangeOf(segment.bSourceI, dFirst);
+    for(int k=1; k<=nPoints; k++) {
+        int iNewRange = iRange;
+        double dValue = segment.dStart + direction*segment.dStep*k;
+        if((k < nPoints) && (qAbs(dValue) > 0.5*segment.dStep))
+            iNewRange = rangeOf(segment.bSourceI, dValue);
+        if((k < nPoints) && (iNewRange == iRange))
+            continue;
+        SweepSegment piece(segment);
+        piece.dStart = segment.dStart + direction*segment.dStep*iFirst;
+        if(k == nPoints)
+            piece.dStop = segment.dStop;
+        else
+            piece.dStop = segment.dStart + direction*segment.dStep*(k-1);
+        piece.dDelay = delay(segment.bSourceI, iRange);
+        piece.bContinued = segment.bContinued || (iFirst > 0);
+        pieces.append(piece);
+        iFirst = k;
+        iRange = iNewRange;
+    }
+    return pieces;
+}
+
+
+QString
+SettlingTable::toString() const {
+    QString sTable;
+    for(int i=0; i<delaysI.count(); i++) {
+        if(delaysI.at(i) >= 0.0)
+            sTable += QString(" I(%1A)=%2").arg(Keithley236::fullScale(false, i)).arg(delaysI.at(i));
+    }
+    for(int i=0; i<delaysV.count(); i++) {
+        if(delaysV.at(i) >= 0.0)
+            sTable += QString(" V(%1V)=%2").arg(Keithley236::fullScale(true, i)).arg(delaysV.at(i));
+    }
+    return sTable.trimmed();
+}
+
+
+// Time [s] after the source step at which the readings, taken every
+// dPeriod, stop leaving the band around the final value. The final
+// value and the noise are estimated from the last quarter of the
+// readings; the band is the largest of dTolerance (relative)
+// and three times the noise.
+double
+SettlingTable::settlingTime(QVector<double> values, double dPeriod, double dTolerance) {
+    int n = values.count();
+    if(n < 8)
+        return -1.0;
+    int nTail = n/4;
+    double sum = 0.0, sum2 = 0.0;
+    for(int i=n-nTail; i<n; i++) {
+        sum  += values.at(i);
+        sum2 += values.at(i)*values.at(i);
+    }
+    double dFinal = sum/nTail;
+    double dNoise = qSqrt(qMax(0.0, (sum2 - nTail*dFinal*dFinal)/(nTail-1)));
+    double dBand = qMax(dTolerance*qAbs(dFinal), 3.0*dNoise);
+    int iLast = -1;
+    for(int i=0; i<n; i++) {
+        if(qAbs(values.at(i)-dFinal) > dBand)
+            iLast = i;
+    }
+    // The reading i is completed (i+1) periods after the step
+    return double(iLast+1)*dPeriod;
+}
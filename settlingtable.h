@@ -0,0 +1,47 @@
+/*
+ *
+Copyright (C) 2016  Gabriele Salvato
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*/
+#pragma once
+
+#include <QVector>
+#include <QString>
+
+#include "sweepprogram.h"
+
+
+// The minimal delay [ms] the sample needs to settle after a source
+// step, measured on each source range of the Keithley 236.
+// The ranges not yet characterised use the default delay.
+class SettlingTable
+{
+public:
+    SettlingTable();
+    void   reset(double dDefaultDelay);
+    int    rangeOf(bool bSourceI, double dSource) const;
+    void   setDelay(bool bSourceI, int iRange, double dDelay);
+    double delay(bool bSourceI, int iRange) const;
+    QVector<SweepSegment> settlingSteps(QVector<SweepSegment> segments) const;
+    QVector<SweepSegment> split(const SweepSegment& segment) const;
+    QString toString() const;
+    static double settlingTime(QVector<double> values, double dPeriod, double dTolerance);
+
+private:
+    double defaultDelay;
+    QVector<double> delaysI;
+    QVector<double> delaysV;
+};
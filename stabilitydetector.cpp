@@ -0,0 +1,89 @@
+/*
+ *
+Copyright (C) 2016  Gabriele Salvato
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*/
+#include "stabilitydetector.h"
+
+#include <QtMath>
+
+
+StabilityDetector::StabilityDetector()
+    : nWindow(0)
+    , iNext(0)
+    , nValues(0)
+    , maxDrift(0.0)
+{
+    reset(10, 0.001);
+}
+
+
+// Forget all the values and prepare a circular buffer of windowSize
+// values. dMaxDrift is the largest relative change per minute
+// of a stable quantity
+void
+StabilityDetector::reset(int windowSize, double dMaxDrift) {
+    nWindow = qMax(windowSize, 3);
+    times.fill(0.0, nWindow);
+    values.fill(0.0, nWindow);
+    iNext    = 0;
+    nValues  = 0;
+    maxDrift = qAbs(dMaxDrift);
+}
+
+
+// dTime in [s]
+void
+StabilityDetector::addValue(double dTime, double dValue) {
+    times[iNext]  = dTime;
+    values[iNext] = dValue;
+    iNext = (iNext+1) % nWindow;
+    if(nValues < nWindow)
+        nValues++;
+}
+
+
+bool
+StabilityDetector::isReady() {
+    return nValues == nWindow;
+}
+
+
+// Least squares slope of the values, relative to their mean, per minute
+double
+StabilityDetector::relativeDrift() {
+    if(nValues < 3)
+        return 0.0;
+    double st = 0.0, sv = 0.0, stt = 0.0, stv = 0.0;
+    for(int i=0; i<nValues; i++) {
+        st  += times.at(i);
+        sv  += values.at(i);
+        stt += times.at(i)*times.at(i);
+        stv += times.at(i)*values.at(i);
+    }
+    double det  = nValues*stt - st*st;
+    double mean = sv/nValues;
+    if((det == 0.0) || (mean == 0.0))
+        return 0.0;
+    double slope = (nValues*stv - st*sv)/det;
+    return 60.0*slope/qAbs(mean);
+}
+
+
+bool
+StabilityDetector::isStable() {
+    return isReady() && (qAbs(relativeDrift()) < maxDrift);
+}
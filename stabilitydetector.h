@@ -0,0 +1,45 @@
+/*
+ *
+Copyright (C) 2016  Gabriele Salvato
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*/
+#pragma once
+
+#include <QVector>
+
+
+// Decides when a slowly drifting quantity (e.g. the sample
+// resistance after a temperature step) can be considered stable:
+// the slope of the straight line through the last values must be
+// below a given fraction of their mean per minute.
+class StabilityDetector
+{
+public:
+    StabilityDetector();
+    void   reset(int windowSize, double dMaxDrift);
+    void   addValue(double dTime, double dValue);
+    bool   isReady();
+    double relativeDrift();
+    bool   isStable();
+
+private:
+    QVector<double> times;
+    QVector<double> values;
+    int    nWindow;
+    int    iNext;
+    int    nValues;
+    double maxDrift;// [1/min]
+};
@@ -0,0 +1,235 @@
+/*
+ *
+Copyright (C) 2016  Gabriele Salvato
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*/
+#include "sweepprogram.h"
+#include "settlingtable.h"
+
+#include <QtMath>
+
+
+SweepSegment::SweepSegment()
+    : bSourceI(true)
+    , dStart(0.0)
+    , dStop(0.0)
+    , dStep(1.0)
+    , dDelay(0.0)
+    , dCompliance(0.0)
+    , bPulsed(false)
+    , dTon(0.0)
+    , dToff(0.0)
+    , bContinued(false)
+{
+}
+
+
+SweepSegment::SweepSegment(bool bSourceI, double dStart, double dStop,
+                           double dStep, double dDelay, double dCompliance)
+    : bSourceI(bSourceI)
+    , dStart(dStart)
+    , dStop(dStop)
+    , dDelay(dDelay)
+    , dCompliance(dCompliance)
+    , bPulsed(false)
+    , dTon(0.0)
+    , dToff(0.0)
+    , bContinued(false)
+{
+    // The smallest step accepted by the Keithley 236
+    if(bSourceI)
+        this->dStep = qMax(qAbs(dStep), 1.0e-13);
+    else
+        this->dStep = qMax(qAbs(dStep), 1.0e-4);
+}
+
+
+// Number of points the segment will produce
+int
+SweepSegment::points() const {
+    return qRound(qAbs(dStop-dStart)/dStep) + 1;
+}
+
+
+// Segments with the same source and compliance can be
+// appended one to the other in the same sweep buffer
+bool
+SweepSegment::isCompatible(const SweepSegment& other) const {
+    return (bSourceI == other.bSourceI) &&
+           (dCompliance == other.dCompliance);
+}
+
+
+SweepProgram::SweepProgram()
+    : maxChunkPoints(1000)// The Keithley 236 Sweep Buffer size
+{
+}
+
+
+void
+SweepProgram::clear() {
+    segmentList.clear();
+    chunkList.clear();
+}
+
+
+void
+SweepProgram::addSegment(const SweepSegment& segment) {
+    segmentList.append(segment);
+    buildChunks();
+}
+
+
+// A closed loop Start -> Stop -> Start.
+// The turning point (Stop) is measured only once
+void
+SweepProgram::addHysteresis(bool bSourceI, double dStart, double dStop,
+                            double dStep, double dDelay, double dCompliance) {
+    segmentList.append(SweepSegment(bSourceI, dStart, dStop, dStep, dDelay, dCompliance));
+    bool bUp = dStop > dStart;
+    double dReturn = bUp ? dStop-dStep : dStop+dStep;
+    if(bUp ? (dReturn >= dStart) : (dReturn <= dStart))
+        segmentList.append(SweepSegment(bSourceI, dReturn, dStart, dStep, dDelay, dCompliance));
+    buildChunks();
+}
+
+
+// Turns all the segments in pulsed sweeps: each point
+// is measured during a pulse lasting dTon and followed
+// by dToff at the bias level (zero)
+void
+SweepProgram::setPulsed(double dTon, double dToff) {
+    for(int i=0; i<segmentList.count(); i++) {
+        segmentList[i].bPulsed = true;
+        segmentList[i].dTon    = dTon;
+        segmentList[i].dToff   = dToff;
+    }
+    buildChunks();
+}
+
+
+// Replaces the delay of the dc segments with the ones measured
+// on each source range (splitting the segments where needed)
+void
+SweepProgram::applySettling(const SettlingTable& table) {
+    QVector<SweepSegment> newList;
+    for(int i=0; i<segmentList.count(); i++)
+        newList += table.split(segmentList.at(i));
+    segmentList = newList;
+    buildChunks();
+}
+
+
+// The pieces of a segment split by range do not count
+int
+SweepProgram::segments() {
+    int nSegments = 0;
+    for(int i=0; i<segmentList.count(); i++) {
+        if(!segmentList.at(i).bContinued)
+            nSegments++;
+    }
+    return nSegments;
+}
+
+
+int
+SweepProgram::groups() {
+    int nGroups = 0;
+    for(int i=0; i<segmentList.count(); i++) {
+        if((i == 0) || !segmentList.at(i).isCompatible(segmentList.at(i-1)))
+            nGroups++;
+    }
+    return nGroups;
+}
+
+
+QVector<SweepSegment>
+SweepProgram::group(int iGroup) {
+    QVector<SweepSegment> groupSegments;
+    int nGroups = -1;
+    for(int i=0; i<segmentList.count(); i++) {
+        if((i == 0) || !segmentList.at(i).isCompatible(segmentList.at(i-1)))
+            nGroups++;
+        if(nGroups == iGroup)
+            groupSegments.append(segmentList.at(i));
+        else if(nGroups > iGroup)
+            break;
+    }
+    return groupSegments;
+}
+
+
+void
+SweepProgram::setMaxChunkPoints(int maxPoints) {
+    maxChunkPoints = qMax(maxPoints, 1);
+    buildChunks();
+}
+
+
+int
+SweepProgram::chunks() {
+    return chunkList.count();
+}
+
+
+QVector<SweepSegment>
+SweepProgram::chunk(int iChunk) {
+    if((iChunk < 0) || (iChunk >= chunkList.count()))
+        return QVector<SweepSegment>();
+    return chunkList.at(iChunk);
+}
+
+
+// Split each group in chunks of at most maxChunkPoints. A segment
+// crossing a chunk boundary is split in two pieces lying on the
+// same staircase, so that the chunks, one after the other, give
+// exactly the points of the whole segment.
+void
+SweepProgram::buildChunks() {
+    chunkList.clear();
+    for(int iGroup=0; iGroup<groups(); iGroup++) {
+        QVector<SweepSegment> groupSegments = group(iGroup);
+        QVector<SweepSegment> currentChunk;
+        int nChunkPoints = 0;
+        for(int i=0; i<groupSegments.count(); i++) {
+            const SweepSegment& segment = groupSegments.at(i);
+            double direction = (segment.dStop >= segment.dStart) ? 1.0 : -1.0;
+            int nLeft = segment.points();
+            int nDone = 0;
+            while(nLeft > 0) {
+                int nPoints = qMin(nLeft, maxChunkPoints-nChunkPoints);
+                SweepSegment piece(segment);
+                piece.dStart = segment.dStart + direction*segment.dStep*nDone;
+                if(nPoints == nLeft)
+                    piece.dStop = segment.dStop;
+                else
+                    piece.dStop = piece.dStart + direction*segment.dStep*(nPoints-1);
+                piece.bContinued = segment.bContinued || (nDone > 0);
+                currentChunk.append(piece);
+                nChunkPoints += nPoints;
+                nDone += nPoints;
+                nLeft -= nPoints;
+                if(nChunkPoints == maxChunkPoints) {
+                    chunkList.append(currentChunk);
+                    currentChunk.clear();
+                    nChunkPoints = 0;
+                }
+            }
+        }
+        if(!currentChunk.isEmpty())
+            chunkList.append(currentChunk);
+    }
+}
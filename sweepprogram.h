@@ -0,0 +1,80 @@
+/*
+ *
+Copyright (C) 2016  Gabriele Salvato
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*/
+#pragma once
+
+#include <QVector>
+
+
+class SettlingTable;
+
+
+// A linear staircase sweep of the Keithley 236: either dc, with a
+// delay before each measure, or pulsed with Ton and Toff times
+class SweepSegment
+{
+public:
+    SweepSegment();
+    SweepSegment(bool bSourceI, double dStart, double dStop,
+                 double dStep, double dDelay, double dCompliance);
+    int    points() const;
+    bool   isCompatible(const SweepSegment& other) const;
+
+public:
+    bool   bSourceI;
+    double dStart;
+    double dStop;
+    double dStep;
+    double dDelay;// [ms]
+    double dCompliance;
+    bool   bPulsed;
+    double dTon; // [ms]
+    double dToff;// [ms]
+    bool   bContinued;// The segment continues in a previous chunk
+};
+
+
+// An ordered list of sweep segments. Consecutive segments sharing
+// the source type and the compliance form a group that the Keithley
+// 236 can run back to back in its sweep buffer. Groups longer than
+// the buffer are split in chunks to be run one after the other.
+class SweepProgram
+{
+public:
+    SweepProgram();
+    void   clear();
+    void   addSegment(const SweepSegment& segment);
+    void   addHysteresis(bool bSourceI, double dStart, double dStop,
+                         double dStep, double dDelay, double dCompliance);
+    void   setPulsed(double dTon, double dToff);
+    void   applySettling(const SettlingTable& table);
+    int    segments();
+    int    groups();
+    QVector<SweepSegment> group(int iGroup);
+    void   setMaxChunkPoints(int maxPoints);
+    int    chunks();
+    QVector<SweepSegment> chunk(int iChunk);
+
+protected:
+    void   buildChunks();
+
+private:
+    QVector<SweepSegment> segmentList;
+    QVector<QVector<SweepSegment>> chunkList;
+    int    maxChunkPoints;
+};
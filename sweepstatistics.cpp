@@ -0,0 +1,112 @@
+/*
+ *
+Copyright (C) 2016  Gabriele Salvato
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*/
+#include "sweepstatistics.h"
+
+#include <QtMath>
+
+
+SweepStatistics::SweepStatistics()
+    : nSweeps(0)
+    , nPoints(0)
+{
+}
+
+
+// Prepare the storage for sweeps of nPoints
+// and forget all the previous sweeps
+void
+SweepStatistics::reset(int nPoints) {
+    this->nPoints = qMax(nPoints, 0);
+    sourceValues.fill(0.0, this->nPoints);
+    meanValues.fill(0.0, this->nPoints);
+    m2Values.fill(0.0, this->nPoints);
+    nSweeps = 0;
+}
+
+
+// To be called before adding the values of a new sweep
+void
+SweepStatistics::startSweep() {
+    nSweeps++;
+}
+
+
+void
+SweepStatistics::addValue(int iPoint, double source, double measure) {
+    if((iPoint < 0) || (iPoint >= nPoints) || (nSweeps < 1))
+        return;
+    if(nSweeps == 1)
+        sourceValues[iPoint] = source;
+    double delta = measure - meanValues.at(iPoint);
+    meanValues[iPoint] += delta/nSweeps;
+    m2Values[iPoint] += delta*(measure - meanValues.at(iPoint));
+}
+
+
+int
+SweepStatistics::sweeps() {
+    return nSweeps;
+}
+
+
+int
+SweepStatistics::points() {
+    return nPoints;
+}
+
+
+double
+SweepStatistics::source(int iPoint) {
+    return sourceValues.at(iPoint);
+}
+
+
+double
+SweepStatistics::mean(int iPoint) {
+    return meanValues.at(iPoint);
+}
+
+
+// Standard error of the mean
+double
+SweepStatistics::standardError(int iPoint) {
+    if(nSweeps < 2)
+        return 0.0;
+    return qSqrt(m2Values.at(iPoint)/(nSweeps-1)/nSweeps);
+}
+
+
+// Worst relative standard error of the sweep. Points close to zero
+// are compared with 1% of the largest value, otherwise the points
+// around the origin of an I-V would never converge.
+double
+SweepStatistics::relativeError() {
+    if(nSweeps < 2)
+        return 0.0;
+    double maxMean = 0.0;
+    for(int i=0; i<nPoints; i++)
+        maxMean = qMax(maxMean, qAbs(meanValues.at(i)));
+    double floor = 0.01*maxMean;
+    if(floor == 0.0)
+        return 0.0;
+    double maxError = 0.0;
+    for(int i=0; i<nPoints; i++)
+        maxError = qMax(maxError, standardError(i)/qMax(qAbs(meanValues.at(i)), floor));
+    return maxError;
+}
@@ -0,0 +1,47 @@
+/*
+ *
+Copyright (C) 2016  Gabriele Salvato
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*/
+#pragma once
+
+#include <QVector>
+
+
+// Accumulates, point by point, the mean and the variance of
+// repeated sweeps with the Welford's streaming algorithm.
+// The storage is allocated once by reset().
+class SweepStatistics
+{
+public:
+    SweepStatistics();
+    void   reset(int nPoints);
+    void   startSweep();
+    void   addValue(int iPoint, double source, double measure);
+    int    sweeps();
+    int    points();
+    double source(int iPoint);
+    double mean(int iPoint);
+    double standardError(int iPoint);
+    double relativeError();
+
+private:
+    QVector<double> sourceValues;
+    QVector<double> meanValues;
+    QVector<double> m2Values;
+    int    nSweeps;
+    int    nPoints;
+};
@@ -0,0 +1,93 @@
+/*
+ *
+Copyright (C) 2016  Gabriele Salvato
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*/
+#include "temperaturegrid.h"
+
+#include <QtMath>
+
+
+TemperatureGrid::TemperatureGrid()
+    : iNext(0)
+    , sign(1.0)
+{
+}
+
+
+// The grid in 1000/T needs positive temperatures:
+// otherwise it is equally spaced in T
+void
+TemperatureGrid::setup(double dTStart, double dTStop, int nPoints, bool bInverseT) {
+    points.clear();
+    iNext = 0;
+    sign = (dTStop >= dTStart) ? 1.0 : -1.0;
+    nPoints = qMax(nPoints, 2);
+    bool bInverse = bInverseT && (dTStart > 0.0) && (dTStop > 0.0);
+    for(int i=0; i<nPoints; i++) {
+        double x = double(i)/double(nPoints-1);
+        if(bInverse) {
+            double invT = 1000.0/dTStart + x*(1000.0/dTStop - 1000.0/dTStart);
+            points.append(1000.0/invT);
+        }
+        else {
+            points.append(dTStart + x*(dTStop-dTStart));
+        }
+    }
+}
+
+
+int
+TemperatureGrid::count() {
+    return points.count();
+}
+
+
+bool
+TemperatureGrid::isDone() {
+    return iNext >= points.count();
+}
+
+
+// The next grid temperature to be met
+double
+TemperatureGrid::target() {
+    if(isDone())
+        return points.isEmpty() ? 0.0 : points.last();
+    return points.at(iNext);
+}
+
+
+void
+TemperatureGrid::advance() {
+    if(!isDone())
+        iNext++;
+}
+
+
+// True if the ramp already went beyond the next grid temperature
+bool
+TemperatureGrid::isPassed(double dTemperature) {
+    if(isDone())
+        return false;
+    return sign*(dTemperature-target()) >= 0.0;
+}
+
+
+double
+TemperatureGrid::direction() {
+    return sign;
+}
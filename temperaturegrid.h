@@ -0,0 +1,43 @@
+/*
+ *
+Copyright (C) 2016  Gabriele Salvato
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*/
+#pragma once
+
+#include <QVector>
+
+
+// The temperatures at which the R vs T readings are wanted,
+// equally spaced in T or in 1000/T (for Arrhenius plots),
+// in the order they are met during the ramp.
+class TemperatureGrid
+{
+public:
+    TemperatureGrid();
+    void   setup(double dTStart, double dTStop, int nPoints, bool bInverseT);
+    int    count();
+    bool   isDone();
+    double target();
+    void   advance();
+    bool   isPassed(double dTemperature);
+    double direction();
+
+private:
+    QVector<double> points;
+    int    iNext;
+    double sign;// +1 when heating, -1 when cooling
+};
@@ -0,0 +1,131 @@
+/*
+ *
+Copyright (C) 2016  Gabriele Salvato
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*/
+#include "temperatureprofile.h"
+
+#include <QtMath>
+
+
+TemperatureProfile::TemperatureProfile()
+{
+}
+
+
+void
+TemperatureProfile::clear() {
+    segments.clear();
+}
+
+
+// dRate [K/min] is the rate at the lower temperature of the segment.
+// The shapes in 1000/T and in log(T) need positive temperatures.
+bool
+TemperatureProfile::addRamp(shape iShape, double dTFrom, double dTTo, double dRate) {
+    if(dRate <= 0.0)
+        return false;
+    double dTLow = qMin(dTFrom, dTTo);
+    double dSeconds;
+    switch(iShape) {
+    case LinearT:
+        dSeconds = 60.0*qAbs(dTTo-dTFrom)/dRate;
+        break;
+    case InverseT:
+        if(dTLow <= 0.0)
+            return false;
+        // d(1/T)/dt = -(dT/dt)/T^2
+        dSeconds = 60.0*qAbs(1.0/dTTo-1.0/dTFrom)*dTLow*dTLow/dRate;
+        break;
+    case LogT:
+        if(dTLow <= 0.0)
+            return false;
+        // d(lnT)/dt = (dT/dt)/T
+        dSeconds = 60.0*qAbs(qLn(dTTo/dTFrom))*dTLow/dRate;
+        break;
+    default:
+        return false;
+    }
+    Segment segment;
+    segment.iShape    = iShape;
+    segment.dTFrom    = dTFrom;
+    segment.dTTo      = dTTo;
+    segment.dDuration = dSeconds;
+    segments.append(segment);
+    return true;
+}
+
+
+void
+TemperatureProfile::addDwell(double dTemperature, double dSeconds) {
+    Segment segment;
+    segment.iShape    = Dwell;
+    segment.dTFrom    = dTemperature;
+    segment.dTTo      = dTemperature;
+    segment.dDuration = qMax(dSeconds, 0.0);
+    segments.append(segment);
+}
+
+
+// [s]
+double
+TemperatureProfile::duration() {
+    double dTotal = 0.0;
+    for(int i=0; i<segments.count(); i++)
+        dTotal += segments.at(i).dDuration;
+    return dTotal;
+}
+
+
+bool
+TemperatureProfile::isDone(double dSeconds) {
+    return dSeconds >= duration();
+}
+
+
+// The set point dSeconds after the start of the profile
+double
+TemperatureProfile::setPoint(double dSeconds) {
+    if(segments.isEmpty())
+        return 0.0;
+    for(int i=0; i<segments.count(); i++) {
+        const Segment& segment = segments.at(i);
+        if(dSeconds >= segment.dDuration) {
+            dSeconds -= segment.dDuration;
+            continue;
+        }
+        double x = qMax(dSeconds, 0.0)/segment.dDuration;
+        switch(segment.iShape) {
+        case InverseT:
+            return 1.0/(1.0/segment.dTFrom + x*(1.0/segment.dTTo-1.0/segment.dTFrom));
+        case LogT:
+            return segment.dTFrom*qExp(x*qLn(segment.dTTo/segment.dTFrom));
+        case Dwell:
+            return segment.dTFrom;
+        default:
+            return segment.dTFrom + x*(segment.dTTo-segment.dTFrom);
+        }
+    }
+    return finalT();
+}
+
+
+double
+TemperatureProfile::finalT() {
+    if(segments.isEmpty())
+        return 0.0;
+    return segments.last().dTTo;
+}
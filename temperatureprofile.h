@@ -0,0 +1,57 @@
+/*
+ *
+Copyright (C) 2016  Gabriele Salvato
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*/
+#pragma once
+
+#include <QVector>
+
+
+// A piecewise temperature program streamed to the Thermostat
+// as a sequence of set points (the LS330 ramps only linearly in T).
+// The ramp rates are the ones at the lower temperature of each
+// segment: the shapes in 1000/T and in log(T) get faster at high T.
+class TemperatureProfile
+{
+public:
+    enum shape {
+        InstrumentRamp = 0,
+        LinearT        = 1,
+        InverseT       = 2,
+        LogT           = 3,
+        Dwell          = 4
+    };
+
+public:
+    TemperatureProfile();
+    void   clear();
+    bool   addRamp(shape iShape, double dTFrom, double dTTo, double dRate);
+    void   addDwell(double dTemperature, double dSeconds);
+    double duration();
+    bool   isDone(double dSeconds);
+    double setPoint(double dSeconds);
+    double finalT();
+
+private:
+    struct Segment {
+        shape  iShape;
+        double dTFrom;   // [K]
+        double dTTo;     // [K]
+        double dDuration;// [s]
+    };
+    QVector<Segment> segments;
+};
@@ -0,0 +1,249 @@
+/*
+ *
+Copyright (C) 2016  Gabriele Salvato
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*/
+#include "temperaturesampler.h"
+
+#include <QElapsedTimer>
+#include <cstring>
+
+
+TemperatureSampler::TemperatureSampler(LakeShore330* pLakeShore, QObject *parent)
+    : QThread(parent)
+    , pLakeShore(pLakeShore)
+    , msInterval(2000)
+    , bBatchedStatus(true)
+    , bOnSampleReady(false)
+    , sequence(0)
+    , sampleTBits(0)
+    , controlTBits(0)
+    , heaterOutputBits(0)
+    , flags(0)
+    , timeStamp(0)
+{
+}
+
+
+TemperatureSampler::~TemperatureSampler() {
+    stopSampling();
+}
+
+
+// Read a first value synchronously, so that the cache is valid
+// as soon as this function returns, then go on in the thread
+void
+TemperatureSampler::startSampling(int msInterval, bool bOnSampleReady) {
+    stopSampling();
+    this->msInterval = qMax(msInterval, 100);
+    this->bOnSampleReady = bOnSampleReady;
+    bBatchedStatus = true;
+    sample();
+    if(bOnSampleReady) {
+        // Direct: the notification may come from the GPIB callback thread
+        connect(pLakeShore, SIGNAL(sampleDataReady()),
+                this, SLOT(onSampleDataReady()),
+                Qt::ConnectionType(Qt::DirectConnection | Qt::UniqueConnection));
+        pLakeShore->setSampleDataSRQ(true);
+    }
+    start();
+}
+
+
+void
+TemperatureSampler::stopSampling() {
+    if(!isRunning())
+        return;
+    if(bOnSampleReady) {
+        disconnect(pLakeShore, SIGNAL(sampleDataReady()),
+                   this, SLOT(onSampleDataReady()));
+        pLakeShore->setSampleDataSRQ(false);
+    }
+    requestInterruption();
+    sampleReady.release();// Wake up the thread
+    wait();
+    sampleReady.tryAcquire(sampleReady.available());
+}
+
+
+void
+TemperatureSampler::onSampleDataReady() {
+    sampleReady.release();
+}
+
+
+int
+TemperatureSampler::interval() {
+    return msInterval;
+}
+
+
+quint64
+TemperatureSampler::toBits(double dValue) {
+    quint64 bits;
+    memcpy(&bits, &dValue, sizeof(bits));
+    return bits;
+}
+
+
+double
+TemperatureSampler::fromBits(quint64 bits) {
+    double dValue;
+    memcpy(&dValue, &bits, sizeof(dValue));
+    return dValue;
+}
+
+
+// Only the sampler thread (or startSampling() before the thread is
+// started) writes the cache: an odd sequence number marks an update
+// in progress
+void
+TemperatureSampler::publish(const LakeShore330::Status& status, bool bStatus, qint64 msecsSinceEpoch) {
+    quint32 statusFlags = (bStatus ? 1 : 0) |
+                          (status.bRamping ? 2 : 0) |
+                          (quint32(status.heaterRange) << 8);
+    quint32 seq = sequence.loadAcquire();
+    sequence.storeRelease(seq+1);
+    sampleTBits.storeRelease(toBits(status.sampleT));
+    controlTBits.storeRelease(toBits(status.controlT));
+    heaterOutputBits.storeRelease(toBits(status.heaterOutput));
+    flags.storeRelease(statusFlags);
+    timeStamp.storeRelease(msecsSinceEpoch);
+    sequence.storeRelease(seq+2);
+}
+
+
+// Returns false if nothing has been read yet.
+// Readers retry while the values are being updated
+bool
+TemperatureSampler::readCache(LakeShore330::Status* pStatus, bool* pbStatus, qint64* pMsecsSinceEpoch) {
+    quint32 seqBefore, seqAfter, statusFlags;
+    quint64 sampleT, controlT, heaterOutput;
+    qint64 msecs;
+    do {
+        seqBefore    = sequence.loadAcquire();
+        sampleT      = sampleTBits.loadAcquire();
+        controlT     = controlTBits.loadAcquire();
+        heaterOutput = heaterOutputBits.loadAcquire();
+        statusFlags  = flags.loadAcquire();
+        msecs        = timeStamp.loadAcquire();
+        seqAfter     = sequence.loadAcquire();
+    } while((seqBefore & 1) || (seqBefore != seqAfter));
+    if(seqBefore == 0)
+        return false;
+    pStatus->sampleT      = fromBits(sampleT);
+    pStatus->controlT     = fromBits(controlT);
+    pStatus->heaterOutput = fromBits(heaterOutput);
+    pStatus->bRamping     = (statusFlags & 2) != 0;
+    pStatus->heaterRange  = int(statusFlags >> 8);
+    *pbStatus = (statusFlags & 1) != 0;
+    if(pMsecsSinceEpoch)
+        *pMsecsSinceEpoch = msecs;
+    return true;
+}
+
+
+bool
+TemperatureSampler::getLatest(double* pTemperature, qint64* pMsecsSinceEpoch) {
+    LakeShore330::Status status;
+    bool bStatus;
+    if(!readCache(&status, &bStatus, pMsecsSinceEpoch))
+        return false;
+    *pTemperature = status.sampleT;
+    return true;
+}
+
+
+// Returns false if the last reading has only the sample temperature
+bool
+TemperatureSampler::getLatestStatus(LakeShore330::Status* pStatus, qint64* pMsecsSinceEpoch) {
+    bool bStatus;
+    if(!readCache(pStatus, &bStatus, pMsecsSinceEpoch))
+        return false;
+    return bStatus;
+}
+
+
+// Age of the cached value [ms] (-1 if there is none)
+qint64
+TemperatureSampler::age() {
+    double T;
+    qint64 msecs;
+    if(!getLatest(&T, &msecs))
+        return -1;
+    return QDateTime::currentMSecsSinceEpoch() - msecs;
+}
+
+
+// The time stamp is taken in the middle of the bus transaction.
+// If the batched query fails, from then on only the
+// temperature is read
+bool
+TemperatureSampler::sample() {
+    LakeShore330::Status status;
+    qint64 tBefore = QDateTime::currentMSecsSinceEpoch();
+    bool bStatus = bBatchedStatus && pLakeShore->getStatus(&status);
+    if(!bStatus) {
+        bBatchedStatus = false;
+        status.sampleT      = pLakeShore->getTemperature();
+        status.controlT     = 0.0;
+        status.bRamping     = false;
+        status.heaterRange  = 0;
+        status.heaterOutput = 0.0;
+    }
+    qint64 tAfter = QDateTime::currentMSecsSinceEpoch();
+    if(status.sampleT <= 0.0)// The reading failed
+        return false;
+    publish(status, bStatus, (tBefore+tAfter)/2);
+    // The heater output is known only from the batched status
+    emit newTemperature(QDateTime::fromMSecsSinceEpoch((tBefore+tAfter)/2),
+                        status.sampleT,
+                        bStatus ? status.heaterOutput : -1.0);
+    return true;
+}
+
+
+// Without Service Requests nobody releases the semaphore
+// and the wait is just the sampling cadence
+void
+TemperatureSampler::run() {
+    QElapsedTimer cadence;
+    cadence.start();
+    qint64 nextSample = msInterval;
+    while(!isInterruptionRequested()) {
+        qint64 msWait = qMax(qint64(0), nextSample-cadence.elapsed());
+        bool bReady = sampleReady.tryAcquire(1, int(msWait));
+        if(isInterruptionRequested())
+            break;
+        if(bReady) {
+            // Notifications arrived while reading count as one
+            sampleReady.tryAcquire(sampleReady.available());
+        }
+        else if(cadence.elapsed() < nextSample) {
+            continue;
+        }
+        sample();
+        if(bReady) {
+            nextSample = cadence.elapsed() + msInterval;
+        }
+        else {
+            // Keep the cadence even if a transaction was slow
+            nextSample += msInterval;
+            if(nextSample < cadence.elapsed())
+                nextSample = cadence.elapsed() + msInterval;
+        }
+    }
+}
@@ -0,0 +1,77 @@
+/*
+ *
+Copyright (C) 2016  Gabriele Salvato
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*/
+#pragma once
+
+#include <QThread>
+#include <QDateTime>
+#include <QAtomicInteger>
+#include <QSemaphore>
+
+#include "lakeshore330.h"
+
+
+// Reads the LakeShore 330 status at a fixed cadence in its own
+// thread or, when required, as soon as the Thermostat signals
+// (with a Service Request) a new reading of the sample sensor;
+// the cadence is then only the longest wait between readings.
+// The latest values and their acquisition time are
+// published in a lock-free cache (a sequence counter guards
+// them as a whole) so that the GUI never waits for the bus.
+// Each reading is a single (batched) bus transaction.
+class TemperatureSampler : public QThread
+{
+    Q_OBJECT
+
+public:
+    explicit TemperatureSampler(LakeShore330* pLakeShore, QObject *parent=Q_NULLPTR);
+    ~TemperatureSampler() Q_DECL_OVERRIDE;
+    void     startSampling(int msInterval, bool bOnSampleReady=false);
+    void     stopSampling();
+    bool     getLatest(double* pTemperature, qint64* pMsecsSinceEpoch);
+    bool     getLatestStatus(LakeShore330::Status* pStatus, qint64* pMsecsSinceEpoch);
+    qint64   age();
+    int      interval();
+
+signals:
+    void     newTemperature(QDateTime sampleTime, double dTemperature, double dHeater);
+
+public slots:
+    void     onSampleDataReady();
+
+protected:
+    void     run() Q_DECL_OVERRIDE;
+    bool     sample();
+    void     publish(const LakeShore330::Status& status, bool bStatus, qint64 msecsSinceEpoch);
+    bool     readCache(LakeShore330::Status* pStatus, bool* pbStatus, qint64* pMsecsSinceEpoch);
+    static quint64 toBits(double dValue);
+    static double  fromBits(quint64 bits);
+
+private:
+    LakeShore330*           pLakeShore;
+    int                     msInterval;
+    bool                    bBatchedStatus;
+    bool                    bOnSampleReady;
+    QSemaphore              sampleReady;
+    QAtomicInteger<quint32> sequence;
+    QAtomicInteger<quint64> sampleTBits;
+    QAtomicInteger<quint64> controlTBits;
+    QAtomicInteger<quint64> heaterOutputBits;
+    QAtomicInteger<quint32> flags;// Status valid, Ramping, Heater Range
+    QAtomicInteger<qint64>  timeStamp;
+};
@@ -0,0 +1,160 @@
+/*
+ *
+Copyright (C) 2016  Gabriele Salvato
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*/
+#include "temperatureseries.h"
+
+#include <QtMath>
+
+
+TemperatureSeries::TemperatureSeries()
+    : nCapacity(0)
+    , iFirst(0)
+    , nSamples(0)
+{
+    reset(256);
+}
+
+
+// Forget all the samples and keep at most capacity of them
+void
+TemperatureSeries::reset(int capacity) {
+    nCapacity = qMax(capacity, 4);
+    times.fill(0, nCapacity);
+    values.fill(0.0, nCapacity);
+    iFirst   = 0;
+    nSamples = 0;
+}
+
+
+int
+TemperatureSeries::count() {
+    return nSamples;
+}
+
+
+// i-th sample in chronological order
+qint64
+TemperatureSeries::time(int i) {
+    return times.at((iFirst+i) % nCapacity);
+}
+
+
+double
+TemperatureSeries::value(int i) {
+    return values.at((iFirst+i) % nCapacity);
+}
+
+
+// Samples must come in chronological order: repeated
+// or older samples are discarded
+void
+TemperatureSeries::addSample(qint64 msecs, double dTemperature) {
+    if((nSamples > 0) && (msecs <= time(nSamples-1)))
+        return;
+    if(nSamples == nCapacity) {
+        iFirst = (iFirst+1) % nCapacity;
+        nSamples--;
+    }
+    int iNext = (iFirst+nSamples) % nCapacity;
+    times[iNext]  = msecs;
+    values[iNext] = dTemperature;
+    nSamples++;
+}
+
+
+// Lagrange polynomial through nPoints samples starting at iFirstPoint,
+// computed at dTime [ms] from the first of them (relative times
+// preserve the precision)
+double
+TemperatureSeries::lagrange(int iFirstPoint, int nPoints, double dTime) {
+    qint64 t0 = time(iFirstPoint);
+    double result = 0.0;
+    for(int i=0; i<nPoints; i++) {
+        double ti = double(time(iFirstPoint+i)-t0);
+        double term = value(iFirstPoint+i);
+        for(int j=0; j<nPoints; j++) {
+            if(j == i) continue;
+            double tj = double(time(iFirstPoint+j)-t0);
+            term *= (dTime-tj)/(ti-tj);
+        }
+        result += term;
+    }
+    return result;
+}
+
+
+// Least squares slope [K/s] of the last nPoints samples.
+// Returns false if there are less than two samples
+bool
+TemperatureSeries::slope(int nPoints, double* pSlope) {
+    int n = qMin(nPoints, nSamples);
+    if(n < 2)
+        return false;
+    int iStart = nSamples - n;
+    qint64 t0 = time(iStart);
+    double st = 0.0, sv = 0.0, stt = 0.0, stv = 0.0;
+    for(int i=iStart; i<nSamples; i++) {
+        double t = double(time(i)-t0)/1000.0;
+        st  += t;
+        sv  += value(i);
+        stt += t*t;
+        stv += t*value(i);
+    }
+    double det = n*stt - st*st;
+    if(det == 0.0)
+        return false;
+    *pSlope = (n*stv - st*sv)/det;
+    return true;
+}
+
+
+// Returns false if there are no samples. Outside the sampled interval
+// the samples at the nearest end are extrapolated (with a larger error)
+bool
+TemperatureSeries::interpolate(qint64 msecs, method iMethod, double* pTemperature, double* pError) {
+    if(nSamples == 0)
+        return false;
+    if(nSamples == 1) {
+        *pTemperature = value(0);
+        *pError = 0.0;
+        return true;
+    }
+    // Find the interval [k, k+1] containing msecs
+    int iLow = 0, iHigh = nSamples-1;
+    while(iHigh-iLow > 1) {
+        int iMid = (iLow+iHigh)/2;
+        if(time(iMid) <= msecs)
+            iLow = iMid;
+        else
+            iHigh = iMid;
+    }
+    int k = iLow;
+    double dTime = double(msecs-time(k));
+    double dLinear = lagrange(k, 2, dTime);
+    double dCubic = dLinear;
+    if(nSamples > 2) {
+        // The cubic uses two points on each side of the interval
+        // (when available)
+        int nPoints = qMin(4, nSamples);
+        int iStart = qBound(0, k-1, nSamples-nPoints);
+        dCubic = lagrange(iStart, nPoints, double(msecs-time(iStart)));
+    }
+    *pTemperature = (iMethod == Cubic) ? dCubic : dLinear;
+    *pError = qAbs(dCubic-dLinear);
+    return true;
+}
@@ -0,0 +1,55 @@
+/*
+ *
+Copyright (C) 2016  Gabriele Salvato
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*/
+#pragma once
+
+#include <QVector>
+
+
+// Time series of the temperature samples of the Thermostat.
+// It gives the temperature at any time (e.g. the acquisition time
+// of an electrical reading) by linear or cubic interpolation of the
+// samples around it. The difference between the two interpolations
+// is used as an estimate of the interpolation error.
+class TemperatureSeries
+{
+public:
+    enum method {
+        Linear = 0,
+        Cubic  = 1
+    };
+
+    TemperatureSeries();
+    void   reset(int capacity);
+    void   addSample(qint64 msecs, double dTemperature);
+    int    count();
+    bool   interpolate(qint64 msecs, method iMethod, double* pTemperature, double* pError);
+    bool   slope(int nPoints, double* pSlope);
+
+protected:
+    qint64 time(int i);
+    double value(int i);
+    double lagrange(int iFirst, int nPoints, double dTime);
+
+private:
+    QVector<qint64> times;// [ms] since Epoch
+    QVector<double> values;
+    int nCapacity;
+    int iFirst;
+    int nSamples;
+};
@@ -0,0 +1,176 @@
+/*
+ *
+Copyright (C) 2016  Gabriele Salvato
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*/
+#include "thermalmodel.h"
+
+#include <QtMath>
+
+
+ThermalModel::ThermalModel()
+    : T0(0.0)
+    , setPoint(0.0)
+    , sumHeater(0.0)
+    , nHeater(0)
+    , K(1.0)
+    , Tau(0.0)
+    , Theta(0.0)
+    , heater(-1.0)
+    , bValid(false)
+{
+}
+
+
+void
+ThermalModel::setParameters(double dGain, double dTau, double dDeadTime) {
+    K      = dGain;
+    Tau    = dTau;
+    Theta  = dDeadTime;
+    bValid = (K > 0.0) && (Tau > 0.0) && (Theta >= 0.0);
+}
+
+
+bool
+ThermalModel::isValid() {
+    return bValid;
+}
+
+
+double
+ThermalModel::gain() {
+    return K;
+}
+
+
+double
+ThermalModel::tau() {
+    return Tau;
+}
+
+
+double
+ThermalModel::deadTime() {
+    return Theta;
+}
+
+
+// A negative value means unknown
+double
+ThermalModel::heaterOutput() {
+    return heater;
+}
+
+
+void
+ThermalModel::startMove(double dT0, double dSetPoint) {
+    times.clear();
+    temperatures.clear();
+    T0        = dT0;
+    setPoint  = dSetPoint;
+    sumHeater = 0.0;
+    nHeater   = 0;
+}
+
+
+// dHeater [%] is negative when not available
+void
+ThermalModel::addSample(double dSeconds, double dTemperature, double dHeater) {
+    if(times.count() >= maxSamples)
+        return;
+    times.append(dSeconds);
+    temperatures.append(dTemperature);
+    if(dHeater >= 0.0) {
+        sumHeater += dHeater;
+        nHeater++;
+    }
+}
+
+
+// First time the response covers dFraction of the move
+double
+ThermalModel::crossingTime(double dFraction, double dTEnd) {
+    double dStep = dTEnd - T0;
+    double yPrev = 0.0;
+    double tPrev = 0.0;
+    for(int i=0; i<times.count(); i++) {
+        double y = (temperatures.at(i)-T0)/dStep;
+        if(y >= dFraction) {
+            if(y == yPrev)
+                return times.at(i);
+            return tPrev + (dFraction-yPrev)*(times.at(i)-tPrev)/(y-yPrev);
+        }
+        yPrev = y;
+        tPrev = times.at(i);
+    }
+    return -1.0;
+}
+
+
+// Two points (28.3% and 63.2%) identification of the move just
+// ended. The new parameters are averaged with the previous ones.
+// Returns false if the move is too small or not yet settled.
+bool
+ThermalModel::fitMove(double dMinStep) {
+    if(qAbs(setPoint-T0) < dMinStep)
+        return false;
+    if(times.count() < 4*endSamples)
+        return false;
+    double dTEnd = 0.0;
+    for(int i=times.count()-endSamples; i<times.count(); i++)
+        dTEnd += temperatures.at(i);
+    dTEnd /= endSamples;
+    double dGain = (dTEnd-T0)/(setPoint-T0);
+    if((dGain < 0.8) || (dGain > 1.2))
+        return false;
+    double t28 = crossingTime(0.283, dTEnd);
+    double t63 = crossingTime(0.632, dTEnd);
+    if((t28 < 0.0) || (t63 <= t28))
+        return false;
+    double dTau      = 1.5*(t63-t28);
+    double dDeadTime = qMax(0.0, t63-dTau);
+    if(bValid) {
+        dGain     = 0.5*(K+dGain);
+        dTau      = 0.5*(Tau+dTau);
+        dDeadTime = 0.5*(Theta+dDeadTime);
+    }
+    setParameters(dGain, dTau, dDeadTime);
+    heater = nHeater > 0 ? sumHeater/nHeater : -1.0;
+    return true;
+}
+
+
+// Predicted time [s] to enter the band around the new set point.
+// The integral action of the controller removes the final offset.
+double
+ThermalModel::timeToSetPoint(double dStep, double dBand) {
+    if(!bValid)
+        return -1.0;
+    if(qAbs(dStep) <= dBand)
+        return 0.0;
+    return Theta + Tau*qLn(qAbs(dStep)/dBand);
+}
+
+
+// With the set point boosted to dBoost times the step, the
+// time [s] after which the true set point must be restored
+// so that the response (delayed by the dead time) lands on it
+double
+ThermalModel::boostTime(double dBoost) {
+    if(!bValid || (K*dBoost <= 1.0))
+        return -1.0;
+    return -Tau*qLn(1.0-1.0/(K*dBoost));
+}
@@ -0,0 +1,61 @@
+/*
+ *
+Copyright (C) 2016  Gabriele Salvato
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*/
+#pragma once
+
+#include <QVector>
+
+
+// First order plus dead time model of the response of the
+// Thermostat to a set point step:
+//   T(t) = T0 + Gain*Step*(1-exp(-(t-DeadTime)/Tau))   for t > DeadTime
+// identified from the temperature recorded during the moves.
+class ThermalModel
+{
+public:
+    ThermalModel();
+    void   setParameters(double dGain, double dTau, double dDeadTime);
+    bool   isValid();
+    double gain();
+    double tau();
+    double deadTime();
+    double heaterOutput();
+    void   startMove(double dT0, double dSetPoint);
+    void   addSample(double dSeconds, double dTemperature, double dHeater);
+    bool   fitMove(double dMinStep);
+    double timeToSetPoint(double dStep, double dBand);
+    double boostTime(double dBoost);
+
+private:
+    double crossingTime(double dFraction, double dTEnd);
+
+private:
+    QVector<double> times;
+    QVector<double> temperatures;
+    double T0;
+    double setPoint;
+    double sumHeater;
+    int    nHeater;
+    double K;
+    double Tau;     // [s]
+    double Theta;   // [s]
+    double heater;  // [%] mean output during the last fitted move
+    bool   bValid;
+    const int maxSamples = 20000;
+    const int endSamples = 5;// Averaged for the final temperature
+};
@@ -0,0 +1,138 @@
+/*
+ *
+Copyright (C) 2016  Gabriele Salvato
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*/
+#include "thermalstability.h"
+
+#include <QtMath>
+
+
+ThermalStabilityDetector::ThermalStabilityDetector()
+    : setPoint(0.0)
+    , window(0.0)
+    , band(0.0)
+    , maxSlope(0.0)
+    , maxSigma(0.0)
+    , approach(0.0)
+    , maxOvershoot(0.0)
+    , fitSlope(0.0)
+    , fitSigma(0.0)
+{
+    reset(300.0, 120.0, 0.15, 0.05, 0.05);
+}
+
+
+// dWindow in [s], dBand and dMaxSigma in [K], dMaxSlope in [K/min]
+void
+ThermalStabilityDetector::reset(double dSetPoint, double dWindow, double dBand, double dMaxSlope, double dMaxSigma) {
+    times.clear();
+    temperatures.clear();
+    setPoint     = dSetPoint;
+    window       = dWindow;
+    band         = qAbs(dBand);
+    maxSlope     = qAbs(dMaxSlope);
+    maxSigma     = qAbs(dMaxSigma);
+    approach     = 0.0;
+    maxOvershoot = 0.0;
+    fitSlope     = 0.0;
+    fitSigma     = 0.0;
+}
+
+
+// dTime in [s]. Samples older than the window are dropped
+void
+ThermalStabilityDetector::addSample(double dTime, double dTemperature) {
+    double deviation = dTemperature - setPoint;
+    // The side of the first sample out of the band
+    // tells from where we are approaching the set point
+    if((approach == 0.0) && (qAbs(deviation) > band))
+        approach = (deviation > 0.0) ? 1.0 : -1.0;
+    if(approach != 0.0)
+        maxOvershoot = qMax(maxOvershoot, -approach*deviation);
+    times.append(dTime);
+    temperatures.append(dTemperature);
+    while(times.count() > minSamples && (dTime-times.at(1)) >= window) {
+        times.remove(0);
+        temperatures.remove(0);
+    }
+    fitLine();
+}
+
+
+void
+ThermalStabilityDetector::fitLine() {
+    fitSlope = 0.0;
+    fitSigma = 0.0;
+    int n = times.count();
+    if(n < 3)
+        return;
+    // Times relative to the first sample preserve the precision
+    double t0 = times.at(0);
+    double st = 0.0, sv = 0.0, stt = 0.0, stv = 0.0;
+    for(int i=0; i<n; i++) {
+        double t = times.at(i)-t0;
+        st  += t;
+        sv  += temperatures.at(i);
+        stt += t*t;
+        stv += t*temperatures.at(i);
+    }
+    double det = n*stt - st*st;
+    if(det == 0.0)
+        return;
+    fitSlope = (n*stv - st*sv)/det;
+    double intercept = (sv - fitSlope*st)/n;
+    double ssr = 0.0;
+    for(int i=0; i<n; i++) {
+        double residual = temperatures.at(i) - (intercept + fitSlope*(times.at(i)-t0));
+        ssr += residual*residual;
+    }
+    fitSigma = qSqrt(ssr/(n-2));
+}
+
+
+// Least squares slope in [K/min]
+double
+ThermalStabilityDetector::slope() {
+    return 60.0*fitSlope;
+}
+
+
+// Standard deviation [K] of the samples around the fitted line
+double
+ThermalStabilityDetector::sigma() {
+    return fitSigma;
+}
+
+
+// Largest excursion [K] beyond the set point
+double
+ThermalStabilityDetector::overshoot() {
+    return maxOvershoot;
+}
+
+
+bool
+ThermalStabilityDetector::isStable() {
+    int n = times.count();
+    if((n < minSamples) || ((times.last()-times.first()) < window))
+        return false;
+    for(int i=0; i<n; i++) {
+        if(qAbs(temperatures.at(i)-setPoint) > band)
+            return false;
+    }
+    return (qAbs(slope()) <= maxSlope) && (sigma() <= maxSigma);
+}
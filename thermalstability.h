@@ -0,0 +1,56 @@
+/*
+ *
+Copyright (C) 2016  Gabriele Salvato
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*/
+#pragma once
+
+#include <QVector>
+
+
+// Decides when the temperature has settled at a new set point
+// looking at the samples of the last window seconds: they must all
+// be inside the band around the set point (i.e. no overshoot still
+// in progress), their least squares slope must be small and
+// the residuals around the straight line must be small too.
+class ThermalStabilityDetector
+{
+public:
+    ThermalStabilityDetector();
+    void   reset(double dSetPoint, double dWindow, double dBand, double dMaxSlope, double dMaxSigma);
+    void   addSample(double dTime, double dTemperature);
+    bool   isStable();
+    double slope();
+    double sigma();
+    double overshoot();
+
+protected:
+    void   fitLine();
+
+private:
+    QVector<double> times;
+    QVector<double> temperatures;
+    double setPoint;
+    double window;   // [s]
+    double band;     // [K]
+    double maxSlope; // [K/min]
+    double maxSigma; // [K]
+    double approach; // +1 coming from above, -1 from below
+    double maxOvershoot;
+    double fitSlope; // [K/s]
+    double fitSigma;
+    const int minSamples = 5;
+};
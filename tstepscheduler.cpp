@@ -0,0 +1,152 @@
+/*
+ *
+Copyright (C) 2016  Gabriele Salvato
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*/
+#include "tstepscheduler.h"
+
+#include <QtMath>
+
+
+TStepScheduler::TStepScheduler()
+    : initialStep(1.0)
+    , minStep(1.0)
+    , maxStep(1.0)
+    , targetChange(0.1)
+    , step(1.0)
+    , change(0.0)
+    , nCurves(0)
+    , lastT(0.0)
+    , lastConductance(0.0)
+    , lastRectification(0.0)
+{
+}
+
+
+// dTargetChange is the wanted change (relative) of the conductance
+// or of the rectification ratio between two set points
+void
+TStepScheduler::reset(double dInitialStep, double dMinStep, double dMaxStep, double dTargetChange) {
+    minStep      = qMin(qAbs(dMinStep), qAbs(dMaxStep));
+    maxStep      = qMax(qAbs(dMinStep), qAbs(dMaxStep));
+    initialStep  = qBound(minStep, qAbs(dInitialStep), maxStep);
+    targetChange = qAbs(dTargetChange);
+    step         = initialStep;
+    change       = 0.0;
+    nCurves      = 0;
+}
+
+
+// Slope of the straight line through the points
+// with the smallest bias (either sign)
+double
+TStepScheduler::zeroBiasConductance(const QVector<double>& voltages, const QVector<double>& currents) {
+    int n = qMin(voltages.count(), currents.count());
+    if(n < 2)
+        return 0.0;
+    QVector<int> nearest;
+    for(int i=0; i<n; i++) {
+        // Insertion sort by |V| of the few points we need
+        int j = nearest.count();
+        nearest.append(i);
+        while(j > 0 && qAbs(voltages.at(nearest.at(j-1))) > qAbs(voltages.at(i))) {
+            nearest[j] = nearest.at(j-1);
+            j--;
+        }
+        nearest[j] = i;
+        if(nearest.count() > nZeroBiasPoints)
+            nearest.remove(nearest.count()-1);
+    }
+    double sv = 0.0, si = 0.0, svv = 0.0, svi = 0.0;
+    int m = nearest.count();
+    for(int k=0; k<m; k++) {
+        double v = voltages.at(nearest.at(k));
+        double c = currents.at(nearest.at(k));
+        sv  += v;
+        si  += c;
+        svv += v*v;
+        svi += v*c;
+    }
+    double det = m*svv - sv*sv;
+    if(det == 0.0)
+        return 0.0;
+    return (m*svi - sv*si)/det;
+}
+
+
+// |I| at the largest positive bias over |I| at the largest
+// negative one (0 if the sweep does not cover both signs)
+double
+TStepScheduler::rectificationRatio(const QVector<double>& voltages, const QVector<double>& currents) {
+    int n = qMin(voltages.count(), currents.count());
+    int iMax = -1, iMin = -1;
+    for(int i=0; i<n; i++) {
+        if((voltages.at(i) > 0.0) && ((iMax < 0) || (voltages.at(i) > voltages.at(iMax))))
+            iMax = i;
+        if((voltages.at(i) < 0.0) && ((iMin < 0) || (voltages.at(i) < voltages.at(iMin))))
+            iMin = i;
+    }
+    if((iMax < 0) || (iMin < 0) || (currents.at(iMin) == 0.0))
+        return 0.0;
+    return qAbs(currents.at(iMax)/currents.at(iMin));
+}
+
+
+// The new step keeps the expected change of the curves close
+// to the target, but it is never changed by more than a factor
+// of two at a time
+void
+TStepScheduler::addCurve(double dTemperature, const QVector<double>& voltages, const QVector<double>& currents) {
+    double conductance   = qAbs(zeroBiasConductance(voltages, currents));
+    double rectification = rectificationRatio(voltages, currents);
+    if(nCurves > 0) {
+        double dT = qAbs(dTemperature-lastT);
+        bool bMeasured = false;
+        change = 0.0;
+        if((conductance > 0.0) && (lastConductance > 0.0)) {
+            change = qAbs(qLn(conductance/lastConductance));
+            bMeasured = true;
+        }
+        if((rectification > 0.0) && (lastRectification > 0.0)) {
+            change = qMax(change, qAbs(qLn(rectification/lastRectification)));
+            bMeasured = true;
+        }
+        // Without a measure of the change the step is kept
+        if(bMeasured && (dT > 0.0)) {
+            double newStep = dT*maxStepFactor;// Nothing changed
+            if(change > 0.0)
+                newStep = qBound(dT/maxStepFactor, targetChange*dT/change, dT*maxStepFactor);
+            step = qBound(minStep, newStep, maxStep);
+        }
+    }
+    lastT             = dTemperature;
+    lastConductance   = conductance;
+    lastRectification = rectification;
+    nCurves++;
+}
+
+
+double
+TStepScheduler::nextStep() {
+    return step;
+}
+
+
+// Relative change (as a log ratio) between the last two curves
+double
+TStepScheduler::lastChange() {
+    return change;
+}
@@ -0,0 +1,53 @@
+/*
+ *
+Copyright (C) 2016  Gabriele Salvato
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*/
+#pragma once
+
+#include <QVector>
+
+
+// Chooses the temperature step of a stepped I-V measurement from how
+// much the I-V curves change between set points: the step is reduced
+// where the zero bias conductance (or the rectification ratio)
+// changes quickly with T and enlarged where they hardly change,
+// always within the given bounds.
+class TStepScheduler
+{
+public:
+    TStepScheduler();
+    void   reset(double dInitialStep, double dMinStep, double dMaxStep, double dTargetChange);
+    void   addCurve(double dTemperature, const QVector<double>& voltages, const QVector<double>& currents);
+    double nextStep();
+    double lastChange();
+    static double zeroBiasConductance(const QVector<double>& voltages, const QVector<double>& currents);
+    static double rectificationRatio(const QVector<double>& voltages, const QVector<double>& currents);
+
+private:
+    double initialStep;
+    double minStep;
+    double maxStep;
+    double targetChange;// Relative change of the curves per step
+    double step;
+    double change;
+    int    nCurves;
+    double lastT;
+    double lastConductance;
+    double lastRectification;
+    static const int nZeroBiasPoints = 5;
+    const double maxStepFactor   = 2.0;
+};